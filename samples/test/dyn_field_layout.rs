@@ -0,0 +1,26 @@
+// Layouts of structs with trait object fields (`contains_generics` used to hit a TODO on `TraitObject`)
+trait Show {
+    fn show(&self) -> u32;
+}
+impl Show for u32 {
+    fn show(&self) -> u32 { *self }
+}
+
+struct Holder<'a> {
+    inner: &'a dyn Show,
+    n: u32,
+}
+struct Callback {
+    f: Box<dyn Fn() -> u32>,
+    n: u32,
+}
+
+fn main()
+{
+    let v = 5u32;
+    let h = Holder { inner: &v, n: 1 };
+    let c = Callback { f: Box::new(move || v * 2), n: 3 };
+    assert_eq!(h.inner.show() + h.n, 6);
+    assert_eq!((c.f)() + c.n, 13);
+    assert_eq!(::std::mem::size_of::<Holder>(), ::std::mem::size_of::<&dyn Show>() + ::std::mem::size_of::<usize>());
+}
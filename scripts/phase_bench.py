@@ -0,0 +1,148 @@
+"""
+Compare per-phase compile times (from `--phase-stats`) between mrustc builds
+
+Generates a synthetic `no_core` crate with lots of small generic functions (so each is monomorphised and optimised
+in the crate), inlinable helpers and constant-foldable arithmetic, then compiles it with each given compiler binary a
+number of times and reports the best wall time of each phase. Also reports a hash of the generated C, so output changes are visible.
+
+C compilation (in the `Trans Codegen` phase) usually dominates the total, set `CC-<target>` (e.g.
+`CC-x86_64-linux-gnu=true`) in the environment to skip it.
+
+Example:
+    python3 scripts/phase_bench.py --functions 400 --repeat 5 old/mrustc bin/mrustc
+"""
+import argparse
+import hashlib
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+HEADER = """\
+#![feature(no_core,lang_items)]
+#![no_core]
+#![crate_type="rlib"]
+#![crate_name="phase_bench"]
+#[lang="sized"] pub trait Sized {}
+#[lang="copy"] pub trait Copy {}
+#[lang="clone"] pub trait Clone: Sized { fn clone(&self) -> Self; }
+#[lang="drop"] pub trait Drop { fn drop(&mut self); }
+#[lang="unsize"] pub trait Unsize<T: ?Sized> {}
+#[lang="coerce_unsized"] pub trait CoerceUnsized<T> {}
+#[lang="fn_once"] pub trait FnOnce<Args> { type Output; }
+#[lang="fn_mut"] pub trait FnMut<Args>: FnOnce<Args> {}
+#[lang="fn"] pub trait Fn<Args>: FnMut<Args> {}
+#[lang="index"] pub trait Index<Idx> { type Output: ?Sized; fn index(&self, i: Idx) -> &Self::Output; }
+#[lang="index_mut"] pub trait IndexMut<Idx>: Index<Idx> { fn index_mut(&mut self, i: Idx) -> &mut Self::Output; }
+#[lang="deref"] pub trait Deref { type Target: ?Sized; fn deref(&self) -> &Self::Target; }
+#[lang="deref_mut"] pub trait DerefMut: Deref { fn deref_mut(&mut self) -> &mut Self::Target; }
+#[lang="add"] pub trait Add<Rhs=Self> { type Output; fn add(self, rhs: Rhs) -> Self::Output; }
+#[lang="mul"] pub trait Mul<Rhs=Self> { type Output; fn mul(self, rhs: Rhs) -> Self::Output; }
+impl Copy for u32 {}
+impl Add for u32 { type Output = u32; fn add(self, o: u32) -> u32 { self + o } }
+impl Mul for u32 { type Output = u32; fn mul(self, o: u32) -> u32 { self * o } }
+pub struct W<T> { v: T }
+impl<T: Copy> W<T> { #[inline] pub fn get(&self) -> T { self.v } }
+pub trait Step { fn step(self, x: u32) -> u32; }
+impl Step for u32 { #[inline] fn step(self, x: u32) -> u32 { self + x } }
+#[inline] fn pick(f: bool, v: u32) -> u32 { if f { v } else { 0 } }
+#[inline] fn twice<T: Step + Copy>(v: T, x: u32) -> u32 { v.step(x) + v.step(x + 1) }
+fn leaf0<T: Step + Copy>(a: T, b: u32) -> u32 { a.step(b) }
+"""
+
+FUNCTION = """\
+#[inline] fn leaf{i}<T: Step + Copy>(a: T, b: u32) -> u32 {{ let t = (a.step(b), b * 2); let w = W {{ v: t.0 + t.1 }}; w.get().step({i}) + leaf{p}(b, 1 + 2) }}
+fn mid{i}<T: Step + Copy>(a: T, f: bool) -> u32 {{
+    let k = 4 * 8 + {i};
+    let mut v = leaf{i}(a, k);
+    if f {{ v = leaf{i}(v, 2); }} else {{ v = twice(v, k); }}
+    pick(f, v) + twice(pick(true, k), 3) + leaf{p}(v, a.step(1))
+}}
+pub fn use{i}(a: u32, f: bool) -> u32 {{ mid{i}(a, f) }}
+"""
+
+
+def generate(path, count):
+    with open(path, 'w') as f:
+        f.write(HEADER)
+        for i in range(1, count + 1):
+            f.write(FUNCTION.format(i=i, p=i - 1))
+
+
+def run_one(binary, src, outdir, threads, extra):
+    stats = os.path.join(outdir, "stats.json")
+    out = os.path.join(outdir, "libphase_bench.rlib")
+    cmd = [binary, src, "-o", out, "--phase-stats", stats, "-Z", "threads=%d" % threads] + extra
+    subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    with open(stats) as f:
+        phases = json.load(f)["phases"]
+    with open(out + ".c", 'rb') as f:
+        c_hash = hashlib.md5(f.read()).hexdigest()[:12]
+    return phases, c_hash
+
+
+def main():
+    argp = argparse.ArgumentParser()
+    argp.add_argument("--functions", type=int, default=400, help="Number of generated function pairs")
+    argp.add_argument("--repeat", type=int, default=5, help="Runs per binary (best time of each phase is reported)")
+    argp.add_argument("--threads", type=int, default=1)
+    argp.add_argument("--phase", action='append', help="Only report phases containing this string (repeatable)")
+    argp.add_argument("-Z", dest="zopts", action='append', default=[], help="Extra -Z option passed to every binary")
+    argp.add_argument("--write-source", help="Write the generated crate to this path and exit")
+    argp.add_argument("binaries", nargs='*')
+    args = argp.parse_args()
+
+    if args.write_source:
+        generate(args.write_source, args.functions)
+        return
+    if not args.binaries:
+        argp.error("no binaries given")
+
+    extra = []
+    for z in args.zopts:
+        extra += ["-Z", z]
+
+    with tempfile.TemporaryDirectory() as tmp:
+        src = os.path.join(tmp, "phase_bench.rs")
+        generate(src, args.functions)
+
+        results = []
+        for binary in args.binaries:
+            best = {}
+            order = []
+            c_hash = None
+            for _ in range(args.repeat):
+                phases, c_hash = run_one(binary, src, tmp, args.threads, extra)
+                for p in phases:
+                    if p["name"] not in best:
+                        order.append(p["name"])
+                        best[p["name"]] = p["wall_s"]
+                    else:
+                        best[p["name"]] = min(best[p["name"]], p["wall_s"])
+            results.append((binary, order, best, c_hash))
+
+    names = []
+    for _, order, _, _ in results:
+        for n in order:
+            if n not in names and (not args.phase or any(f in n for f in args.phase)):
+                names.append(n)
+
+    width = max(len(n) for n in names + ["Total"])
+    sys.stdout.write("%-*s" % (width, "Phase"))
+    for i, _ in enumerate(results):
+        sys.stdout.write("%12s" % ("[%d] s" % i))
+    sys.stdout.write("\n")
+    for n in names:
+        sys.stdout.write("%-*s" % (width, n))
+        for _, _, best, _ in results:
+            sys.stdout.write("%12.3f" % best[n] if n in best else "%12s" % "-")
+        sys.stdout.write("\n")
+    sys.stdout.write("%-*s" % (width, "Total"))
+    for _, _, best, _ in results:
+        sys.stdout.write("%12.3f" % sum(best.values()))
+    sys.stdout.write("\n\n")
+    for i, (binary, _, _, c_hash) in enumerate(results):
+        sys.stdout.write("[%d] %s (C output %s)\n" % (i, binary, c_hash))
+
+main()
@@ -11,7 +11,9 @@
 #include "../expand/cfg.hpp"
 #include <hir/hir.hpp>  // HIR::Crate
 #include <hir/main_bindings.hpp>    // HIR_Deserialise
+#include <thread_pool.hpp>
 #include <fstream>
+#include <algorithm>
 #ifdef _WIN32
 # define NOGDI  // prevent ERROR from being defined
 # include <Windows.h>
@@ -64,14 +66,18 @@ Crate::Crate():
 
 void Crate::load_externs()
 {
-    auto cb = [this](Module& mod) {
+    // Collect all `extern crate` items first, so they (and their dependencies) can be loaded together
+    ::std::vector<ExternCrateLoad>  to_load;
+    ::std::vector<RcString*>    load_names;
+    auto cb = [&](Module& mod) {
         for( /*const*/ auto& it : mod.items() )
         {
             if( auto* c = it.data.opt_Crate() )
             {
                 if( check_item_cfg(it.attrs) )
                 {
-                    c->name = load_extern_crate( it.span, c->name.c_str() );
+                    to_load.push_back(ExternCrateLoad { it.span, c->name, "" });
+                    load_names.push_back(&c->name);
                 }
             }
         }
@@ -102,23 +108,35 @@ void Crate::load_externs()
         }
     }
 
+    const char* std_name = nullptr;
     if( no_core ) {
         // Don't load anything
     }
     else if( no_std ) {
-        auto n = this->load_extern_crate(Span(), "core");
-        ASSERT_BUG(Span(), n == "core", "libcore wasn't loaded as `core`, instead `" << n << "`");
+        std_name = "core";
     }
     else {
-        auto n = this->load_extern_crate(Span(), "std");
-        ASSERT_BUG(Span(), n == "std", "libstd wasn't loaded as `std`, instead `" << n << "`");
+        std_name = "std";
+    }
+    if( std_name ) {
+        to_load.push_back(ExternCrateLoad { Span(), RcString::new_interned(std_name), "" });
+    }
+
+    auto loaded = this->load_extern_crates(mv$(to_load));
+    for(size_t i = 0; i < load_names.size(); i ++)
+    {
+        *load_names[i] = loaded[i];
+    }
+    if( std_name ) {
+        const auto& n = loaded.back();
+        ASSERT_BUG(Span(), n == std_name, "lib" << std_name << " wasn't loaded as `" << std_name << "`, instead `" << n << "`");
     }
 }
 // TODO: Handle disambiguating crates with the same name (e.g. libc in std and crates.io libc)
 // - Crates recorded in rlibs should specify a hash/tag that's passed in to this function.
-RcString Crate::load_extern_crate(Span sp, const RcString& name, const ::std::string& basename/*=""*/)
+static ::std::string find_extern_crate(const Span& sp, const RcString& name, const ::std::string& basename)
 {
-    TRACE_FUNCTION_F("Loading crate '" << name << "' (basename='" << basename << "')");
+    TRACE_FUNCTION_F("Searching for crate '" << name << "' (basename='" << basename << "')");
 
     ::std::string   path;
     auto it = g_crate_overrides.find(name.c_str());
@@ -232,45 +250,112 @@ RcString Crate::load_extern_crate(Span sp, const RcString& name, const ::std::st
         DEBUG("path = " << path << " (search)");
     }
 
-    // NOTE: Creating `ExternCrate` loads the crate from the specified path
-    auto ec = ExternCrate { name, path };
-    auto real_name = ec.m_hir->m_crate_name;
-    assert(real_name != "");
-    auto res = m_extern_crates.insert(::std::make_pair( real_name, mv$(ec) ));
-    if( !res.second ) {
-        // Crate already loaded?
+    return path;
+}
+
+RcString Crate::load_extern_crate(Span sp, const RcString& name, const ::std::string& basename/*=""*/)
+{
+    return load_extern_crates({ ExternCrateLoad { mv$(sp), name, basename } }).front();
+}
+::std::vector<RcString> Crate::load_extern_crates(::std::vector<ExternCrateLoad> crates)
+{
+    TRACE_FUNCTION_F(crates.size() << " crates");
+    struct Pending {
+        Span    sp;
+        // Name that the crate was requested with
+        RcString    name;
+        ::std::string   path;
+        ::HIR::CratePtr hir;
+    };
+
+    ::std::vector<RcString> rv(crates.size());
+    ::std::vector<size_t>   root_slots(crates.size(), SIZE_MAX);
+
+    // Find the files for the requested crates, skipping any that are already loaded
+    ::std::vector<Pending>  wave;
+    for(size_t i = 0; i < crates.size(); i ++)
+    {
+        const auto& c = crates[i];
+        auto path = find_extern_crate(c.sp, c.name, c.basename);
+        auto it = ::std::find_if(m_extern_crates.begin(), m_extern_crates.end(), [&](const auto& e){ return e.second.m_filename == path; });
+        if( it != m_extern_crates.end() ) {
+            DEBUG("'" << c.name << "' already loaded from '" << path << "' as '" << it->first << "'");
+            rv[i] = it->first;
+            continue ;
+        }
+        auto w_it = ::std::find_if(wave.begin(), wave.end(), [&](const Pending& p){ return p.path == path; });
+        root_slots[i] = w_it - wave.begin();
+        if( w_it == wave.end() ) {
+            wave.push_back(Pending { c.sp, c.name, mv$(path), {} });
+        }
     }
-    auto& ext_crate = res.first->second;
-    // Move the external list out (doesn't need to be kept in the nested crate)
-    //auto crate_ext_list = mv$( ext_crate.m_hir->m_ext_crates );
-    const auto& crate_ext_list = ext_crate.m_hir->m_ext_crates;
 
-    // Load referenced crates
-    for( const auto& ext : crate_ext_list )
+    // Load crates a wave at a time (each wave being the not-yet-loaded dependencies of the previous one)
+    // - Deserialisation is independent for each crate, so is done in parallel
+    // - Registering the crates (and discovering their dependencies) is done serially
+    ThreadPool  pool;
+    for(bool is_root = true; !wave.empty(); is_root = false)
     {
-        if( m_extern_crates.count(ext.first) == 0 )
+        DEBUG("Deserialising " << wave.size() << " crates");
+        pool.for_each_index(wave.size(), [&](size_t i) {
+            wave[i].hir = HIR_Deserialise(wave[i].path);
+            });
+
+        ::std::vector<RcString> loaded_names;
+        for(auto& p : wave)
+        {
+            // NOTE: Creating `ExternCrate` does post-load fixups
+            auto ec = ExternCrate { p.name, p.path, mv$(p.hir) };
+            auto real_name = ec.m_name;
+            assert(real_name != "");
+            if( !is_root && real_name != p.name )
+            {
+                // ERROR - The crate loaded wasn't the one that was used when compiling the crate that referenced it.
+                ERROR(p.sp, E0000, "The crate file `" << p.path << "` didn't load the expected crate - have " << real_name << " != exp " << p.name);
+            }
+            auto res = m_extern_crates.insert(::std::make_pair( real_name, mv$(ec) ));
+            if( !res.second ) {
+                // Crate already loaded?
+            }
+            DEBUG("Loaded '" << p.name << "' from '" << p.path << "' (actual name is '" << real_name << "')");
+            loaded_names.push_back(real_name);
+        }
+        if( is_root )
         {
-            const auto load_name = this->load_extern_crate(sp, ext.first, ext.second.m_basename);
-            if( load_name != ext.first )
+            for(size_t i = 0; i < crates.size(); i ++)
             {
-                // ERROR - The crate loaded wasn't the one that was used when compiling this crate.
-                ERROR(sp, E0000, "The crate file `" << ext.second.m_basename << "` didn't load the expected crate - have " << load_name << " != exp " << ext.first);
+                if( root_slots[i] != SIZE_MAX )
+                    rv[i] = loaded_names[root_slots[i]];
             }
         }
+
+        // Collect referenced crates that aren't yet loaded
+        ::std::vector<Pending>  next_wave;
+        for(size_t i = 0; i < wave.size(); i ++)
+        {
+            for( const auto& ext : m_extern_crates.at(loaded_names[i]).m_hir->m_ext_crates )
+            {
+                if( m_extern_crates.count(ext.first) != 0 )
+                    continue ;
+                if( ::std::any_of(next_wave.begin(), next_wave.end(), [&](const Pending& p){ return p.name == ext.first; }) )
+                    continue ;
+                auto path = find_extern_crate(wave[i].sp, ext.first, ext.second.m_basename);
+                next_wave.push_back(Pending { wave[i].sp, ext.first, mv$(path), {} });
+            }
+        }
+        wave = mv$(next_wave);
     }
 
-    DEBUG("Loaded '" << name << "' from '" << basename << "' (actual name is '" << real_name << "')");
-    return real_name;
+    return rv;
 }
 
-ExternCrate::ExternCrate(const RcString& name, const ::std::string& path):
+ExternCrate::ExternCrate(const RcString& name, const ::std::string& path, ::HIR::CratePtr hir):
     m_name(name),
     m_short_name(name),
-    m_filename(path)
+    m_filename(path),
+    m_hir(mv$(hir))
 {
     TRACE_FUNCTION_F("name=" << name << ", path='" << path << "'");
-    m_hir = HIR_Deserialise(path);
-
     m_hir->post_load_update(name);
     m_name = m_hir->m_crate_name;
 }
@@ -41,6 +41,15 @@ public:
     ::std::vector<::std::string>    attributes;
 };
 
+/// Request to load an extern crate (see `Crate::load_extern_crates`)
+struct ExternCrateLoad
+{
+    Span    sp;
+    RcString    name;
+    /// If non-empty, the exact file to load
+    ::std::string   basename;
+};
+
 class Crate
 {
 public:
@@ -92,6 +101,9 @@ public:
     /// Load the named crate and returns the crate's unique name
     /// If the parameter `file` is non-empty, only that particular filename will be loaded (from any of the search paths)
     RcString load_extern_crate(Span sp, const RcString& name, const ::std::string& file="");
+    /// Load several crates (and all of their dependencies) at once, returning the unique name of each
+    /// - Metadata for independent crates is deserialised in parallel
+    ::std::vector<RcString> load_extern_crates(::std::vector<ExternCrateLoad> crates);
 };
 
 /// Representation of an imported crate
@@ -103,7 +115,8 @@ public:
     ::std::string   m_filename;
     ::HIR::CratePtr m_hir;
 
-    ExternCrate(const RcString& name, const ::std::string& path);
+    /// Wrap a crate loaded from `path` (doing post-load fixups)
+    ExternCrate(const RcString& name, const ::std::string& path, ::HIR::CratePtr hir);
 
     ExternCrate(ExternCrate&&) = default;
     ExternCrate& operator=(ExternCrate&&) = default;
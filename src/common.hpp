@@ -190,6 +190,12 @@ Ordering ord(const ::std::map<T,U>& l, const ::std::map<T,U>& r)
 }
 #define ORD(a,b)    do { Ordering ORD_rv = ::ord(a,b); if( ORD_rv != ::OrdEqual )   return ORD_rv; } while(0)
 
+/// Mix a value into a running hash (same mixing as boost::hash_combine)
+static inline size_t hash_combine(size_t seed, size_t v)
+{
+    return seed ^ (v + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
 
 template <typename T>
 struct LList
@@ -12,56 +12,57 @@
 #include <iomanip>
 #include <common.hpp>   // FmtEscaped
 #include <cstring>	// strchr
+#include <cstdlib>	// malloc/free
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <new>
+#ifdef _WIN32
+# include <Windows.h>
+# include <Psapi.h>
+#else
+# include <sys/resource.h>
+#endif
 
 
-int g_debug_indent_level = 0;
-bool g_debug_enabled = true;
+// NOTE: Indent, enable flag and output stream are per-thread (worker threads get them via `DebugThreadContext`)
+thread_local int g_debug_indent_level = 0;
+thread_local bool g_debug_enabled = true;
+thread_local ::std::ostringstream* g_debug_sink = nullptr;
+// Only changed by the main thread between phases
 ::std::string g_cur_phase;
 ::std::set< ::std::string>    g_debug_disable_map;
 
-TraceLog::TraceLog(const char* tag, ::std::function<void(::std::ostream&)> info_cb, ::std::function<void(::std::ostream&)> ret):
-    m_tag(tag),
-    m_ret(ret)
-{
-    if(debug_enabled() && m_tag) {
-        auto& os = debug_output(g_debug_indent_level, m_tag);
-        os << ">> (";
-        info_cb(os);
-        os << ")" << ::std::endl;
-    }
-    INDENT();
-}
-TraceLog::TraceLog(const char* tag, ::std::function<void(::std::ostream&)> info_cb):
-    m_tag(tag),
-    m_ret([](const auto&){})
-{
-    if(debug_enabled() && m_tag) {
-        auto& os = debug_output(g_debug_indent_level, m_tag);
-        os << ">> (";
-        info_cb(os);
-        os << ")" << ::std::endl;
-    }
-    INDENT();
-}
 TraceLog::TraceLog(const char* tag):
-    m_tag(tag),
-    m_ret([](const auto&){})
+    m_tag(tag)
 {
-    if(debug_enabled() && m_tag) {
-        auto& os = debug_output(g_debug_indent_level, m_tag);
-        os << ">>" << ::std::endl;
+    if(m_tag) {
+        debug_output(g_debug_indent_level, m_tag) << ">>" << ::std::endl;
     }
     INDENT();
 }
 TraceLog::~TraceLog() {
     UNINDENT();
-    if(debug_enabled() && m_tag) {
-        auto& os = debug_output(g_debug_indent_level, m_tag);
-        os << "<< (";
-        m_ret(os);
-        os << ")" << ::std::endl;
+    if(m_tag) {
+        exit_end(exit_begin(m_tag));
     }
 }
+::std::ostream& TraceLog::enter_begin(const char* tag)
+{
+    return debug_output(g_debug_indent_level, tag) << ">> (";
+}
+void TraceLog::enter_end(::std::ostream& os)
+{
+    os << ")" << ::std::endl;
+}
+::std::ostream& TraceLog::exit_begin(const char* tag)
+{
+    return debug_output(g_debug_indent_level, tag) << "<< (";
+}
+void TraceLog::exit_end(::std::ostream& os)
+{
+    os << ")" << ::std::endl;
+}
 
 
 
@@ -77,29 +78,235 @@ bool debug_enabled()
 {
     return g_debug_enabled;
 }
+::std::ostream& debug_stream()
+{
+    return g_debug_sink ? *g_debug_sink : ::std::cout;
+}
 ::std::ostream& debug_output(int indent, const char* function)
 {
-    return ::std::cout << g_cur_phase << "- " << RepeatLitStr { " ", indent } << function << ": ";
+    return debug_stream() << g_cur_phase << "- " << RepeatLitStr { " ", indent } << function << ": ";
+}
+
+DebugThreadContext::State DebugThreadContext::capture()
+{
+    return State { g_debug_indent_level, g_debug_enabled };
+}
+DebugThreadContext::DebugThreadContext(const State& parent, ::std::ostringstream* sink):
+    m_saved_indent(g_debug_indent_level),
+    m_saved_enabled(g_debug_enabled),
+    m_saved_sink(g_debug_sink)
+{
+    g_debug_indent_level = parent.indent_level;
+    g_debug_enabled = parent.enabled;
+    g_debug_sink = sink;
+}
+DebugThreadContext::~DebugThreadContext()
+{
+    g_debug_indent_level = m_saved_indent;
+    g_debug_enabled = m_saved_enabled;
+    g_debug_sink = m_saved_sink;
+}
+
+void debug_flush_buffered()
+{
+    // Written straight out (out of order), as the task's buffer would otherwise be lost when the process stops
+    if( g_debug_sink && g_debug_sink->tellp() > 0 )
+    {
+        static ::std::mutex lock;
+        ::std::lock_guard< ::std::mutex>    lh { lock };
+        ::std::cout << g_debug_sink->str();
+        ::std::cout.flush();
+        g_debug_sink->str("");
+    }
+}
+
+// --------------------------------------------------------------------
+// Phase statistics (`--phase-stats`)
+// --------------------------------------------------------------------
+namespace {
+    // NOTE: Plain flag, set before any worker threads start (so the allocator hook is a single check when disabled)
+    bool    g_phase_stats_enabled = false;
+    ::std::atomic<uint64_t> g_alloc_count { 0 };
+    ::std::atomic<uint64_t> g_alloc_bytes { 0 };
+
+    struct PhaseStats
+    {
+        const char* name;
+        double  wall;
+        double  cpu;
+        uint64_t    peak_rss;
+        uint64_t    peak_rss_delta;
+        uint64_t    alloc_count;
+        uint64_t    alloc_bytes;
+        ::std::vector< ::std::pair<const char*, size_t> >   item_counts;
+    };
+    ::std::string   g_phase_stats_path;
+    ::std::vector<PhaseStats>   g_phase_stats;
+    t_debug_item_counter    g_phase_item_counter;
+
+    /// Peak resident set size of the process, in bytes
+    uint64_t get_peak_rss()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS pmc;
+        if( !K32GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)) )
+            return 0;
+        return pmc.PeakWorkingSetSize;
+#else
+        struct rusage   ru;
+        if( getrusage(RUSAGE_SELF, &ru) != 0 )
+            return 0;
+# ifdef __APPLE__
+        return ru.ru_maxrss;
+# else
+        return static_cast<uint64_t>(ru.ru_maxrss) * 1024;
+# endif
+#endif
+    }
+
+    void write_phase_stats()
+    {
+        ::std::ofstream os(g_phase_stats_path);
+        if( !os.good() ) {
+            ::std::cerr << "WARN: Unable to open '" << g_phase_stats_path << "' for writing phase stats" << ::std::endl;
+            return ;
+        }
+        os << "{\n";
+        os << "  \"phases\": [";
+        bool first = true;
+        for(const auto& ps : g_phase_stats)
+        {
+            os << (first ? "\n" : ",\n");
+            first = false;
+            os << "    {";
+            os << "\"name\": \"" << ps.name << "\"";
+            os << ", \"wall_s\": " << ::std::fixed << ::std::setprecision(6) << ps.wall;
+            os << ", \"cpu_s\": " << ps.cpu;
+            os << ", \"peak_rss_bytes\": " << ps.peak_rss;
+            os << ", \"peak_rss_delta_bytes\": " << ps.peak_rss_delta;
+            os << ", \"alloc_count\": " << ps.alloc_count;
+            os << ", \"alloc_bytes\": " << ps.alloc_bytes;
+            os << ", \"items\": {";
+            for(size_t i = 0; i < ps.item_counts.size(); i ++)
+            {
+                if(i > 0)   os << ", ";
+                os << "\"" << ps.item_counts[i].first << "\": " << ps.item_counts[i].second;
+            }
+            os << "}";
+            os << "}";
+        }
+        os << "\n  ]\n";
+        os << "}\n";
+    }
+}
+
+void debug_enable_phase_stats(::std::string path)
+{
+    g_phase_stats_path = ::std::move(path);
+    g_phase_stats_enabled = true;
+}
+void debug_set_phase_item_counter(t_debug_item_counter cb)
+{
+    g_phase_item_counter = ::std::move(cb);
+}
+
+// Counting allocator hook, used for the phase stats allocation counts
+void* operator new(size_t size)
+{
+    if( g_phase_stats_enabled ) {
+        g_alloc_count.fetch_add(1, ::std::memory_order_relaxed);
+        g_alloc_bytes.fetch_add(size, ::std::memory_order_relaxed);
+    }
+    for(;;)
+    {
+        if( void* rv = ::std::malloc(size ? size : 1) )
+            return rv;
+        auto handler = ::std::get_new_handler();
+        if( !handler )
+            throw ::std::bad_alloc();
+        handler();
+    }
+}
+void* operator new[](size_t size)
+{
+    return ::operator new(size);
+}
+void operator delete(void* ptr) noexcept
+{
+    ::std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept
+{
+    ::std::free(ptr);
+}
+
+namespace {
+    /// CPU time used by the whole process (i.e. including all worker threads), in seconds
+    double get_process_cpu_time()
+    {
+#ifdef _WIN32
+        // - `clock` is wall time on windows
+        FILETIME    creation, exit, kernel, user;
+        if( !GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user) )
+            return 0.0;
+        auto to_u64 = [](const FILETIME& ft){ return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime; };
+        return static_cast<double>(to_u64(kernel) + to_u64(user)) / 1e7;
+#else
+        return static_cast<double>(clock()) / static_cast<double>(CLOCKS_PER_SEC);
+#endif
+    }
 }
 
 DebugTimedPhase::DebugTimedPhase(const char* name):
-    m_name(name)
+    m_name(name),
+    m_peak_rss_start(0),
+    m_alloc_count_start(0),
+    m_alloc_bytes_start(0)
 {
     ::std::cout << m_name << ": V V V" << ::std::endl;
     g_cur_phase = m_name;
     g_debug_enabled = debug_enabled_update();
-    m_start = clock();
+    if( g_phase_stats_enabled ) {
+        m_peak_rss_start = get_peak_rss();
+        m_alloc_count_start = g_alloc_count;
+        m_alloc_bytes_start = g_alloc_bytes;
+    }
+    m_cpu_start = get_process_cpu_time();
+    m_wall_start = ::std::chrono::steady_clock::now();
 }
 DebugTimedPhase::~DebugTimedPhase()
 {
-    auto end = clock();
+    auto wall = ::std::chrono::duration<double>(::std::chrono::steady_clock::now() - m_wall_start).count();
+    auto cpu = get_process_cpu_time() - m_cpu_start;
     g_cur_phase = "";
     g_debug_enabled = debug_enabled_update();
 
-    // TODO: Show wall time too?
-    ::std::cout << "(" << ::std::fixed << ::std::setprecision(2) << static_cast<double>(end - m_start) / static_cast<double>(CLOCKS_PER_SEC) << " s) ";
+    // NOTE: CPU time is summed over all threads, so can exceed wall time for parallel phases
+    ::std::cout << "(" << ::std::fixed << ::std::setprecision(2) << wall << " s wall, " << cpu << " s CPU) ";
     ::std::cout << m_name << ": DONE";
     ::std::cout << ::std::endl;
+
+    if( g_phase_stats_enabled )
+    {
+        PhaseStats  ps;
+        ps.name = m_name;
+        ps.wall = wall;
+        ps.cpu = cpu;
+        ps.peak_rss = get_peak_rss();
+        ps.peak_rss_delta = ps.peak_rss - m_peak_rss_start;
+        ps.alloc_count = g_alloc_count - m_alloc_count_start;
+        ps.alloc_bytes = g_alloc_bytes - m_alloc_bytes_start;
+        if( g_phase_item_counter )
+        {
+            // The counter visits the whole crate, which would otherwise emit trace output (debug is on between phases)
+            g_debug_enabled = false;
+            g_phase_item_counter(ps.item_counts);
+            g_debug_enabled = debug_enabled_update();
+        }
+        g_phase_stats.push_back(::std::move(ps));
+        // Written after every phase, so the data is still avaliable if compilation fails
+        write_phase_stats();
+    }
 }
 
 extern void debug_init_phases(const char* env_var_name, std::initializer_list<const char*> il)
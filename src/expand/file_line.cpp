@@ -11,12 +11,13 @@
 #include <ast/crate.hpp>
 
 namespace {
-    const Span& get_top_span(const Span& sp) {
-        if( sp.outer_span ) {
-            return get_top_span(*sp.outer_span);
+    const SpanData& get_top_span(const Span& sp) {
+        auto outer = sp.outer_span();
+        if( !outer.is_empty() ) {
+            return get_top_span(outer);
         }
         else {
-            return sp;
+            return sp.data();
         }
     }
 }
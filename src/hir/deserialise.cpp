@@ -22,6 +22,22 @@
     {
     };
 
+    /// Undecoded MIR body from crate metadata
+    class MirLoader:
+        public ::MIR::FunctionLoader
+    {
+        RcString    m_crate_name;
+        ::std::shared_ptr<const ::HIR::serialise::ReaderTables> m_tables;
+        ::HIR::serialise::Blob  m_data;
+    public:
+        MirLoader(RcString crate_name, ::std::shared_ptr<const ::HIR::serialise::ReaderTables> tables, ::HIR::serialise::Blob data):
+            m_crate_name(mv$(crate_name)),
+            m_tables(mv$(tables)),
+            m_data(mv$(data))
+        {}
+        ::MIR::Function* load() override;
+    };
+
     class HirDeserialiser
     {
         RcString m_crate_name;
@@ -30,6 +46,10 @@
         HirDeserialiser(::HIR::serialise::Reader& in):
             m_in(in)
         {}
+        HirDeserialiser(::HIR::serialise::Reader& in, RcString crate_name):
+            m_crate_name(mv$(crate_name)),
+            m_in(in)
+        {}
 
         RcString read_istring() { return m_in.read_istring(); }
         ::std::string read_string() { return m_in.read_string(); }
@@ -451,12 +471,13 @@
             ::HIR::ExprPtr  rv;
             if( m_in.read_bool() )
             {
-                rv.m_mir = deserialise_mir();
+                // Only decoded when first used (most bodies in a library are never needed downstream)
+                rv.m_mir = ::MIR::FunctionPointer( new MirLoader(m_crate_name, m_in.tables(), m_in.read_blob()) );
             }
             rv.m_erased_types = deserialise_vec< ::HIR::TypeRef>();
             return rv;
         }
-        ::MIR::FunctionPointer deserialise_mir();
+        ::MIR::Function deserialise_mir();
         ::MIR::BasicBlock deserialise_mir_basicblock();
         ::MIR::Statement deserialise_mir_statement();
         ::MIR::Terminator deserialise_mir_terminator();
@@ -1176,7 +1197,7 @@
         }
     }
 
-    ::MIR::FunctionPointer HirDeserialiser::deserialise_mir()
+    ::MIR::Function HirDeserialiser::deserialise_mir()
     {
         TRACE_FUNCTION;
 
@@ -1187,7 +1208,15 @@
         rv.drop_flags = deserialise_vec<bool>();
         rv.blocks = deserialise_vec< ::MIR::BasicBlock>( );
 
-        return ::MIR::FunctionPointer( new ::MIR::Function(mv$(rv)) );
+        return rv;
+    }
+
+    ::MIR::Function* MirLoader::load()
+    {
+        TRACE_FUNCTION_F(m_crate_name);
+        ::HIR::serialise::Reader    in { mv$(m_tables), mv$(m_data) };
+        HirDeserialiser s { in, m_crate_name };
+        return new ::MIR::Function( s.deserialise_mir() );
     }
     ::MIR::BasicBlock HirDeserialiser::deserialise_mir_basicblock()
     {
@@ -1399,3 +1428,24 @@
     #endif
 }
 
+
+bool HIR_DeserialiseMonomorphisedMir(const ::std::string& filename, const ::std::string& key, ::HIR::TypeRef& ret_ty, ::std::vector< ::HIR::TypeRef>& arg_tys, ::MIR::FunctionPointer& mir)
+{
+    try
+    {
+        ::HIR::serialise::Reader    in{ filename };
+        // Guards against hash collisions in the filename
+        if( in.read_string() != key )
+            return false;
+        HirDeserialiser  s { in };
+        ret_ty = s.deserialise_type();
+        arg_tys = s.deserialise_vec< ::HIR::TypeRef>();
+        mir = ::MIR::FunctionPointer( new ::MIR::Function(s.deserialise_mir()) );
+        return true;
+    }
+    catch(const ::std::runtime_error& e)
+    {
+        DEBUG("Unable to load cached MIR from " << filename << ": " << e.what());
+        return false;
+    }
+}
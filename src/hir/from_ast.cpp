@@ -135,7 +135,7 @@ HIR::LifetimeRef LowerHIR_LifetimeRef(const ::AST::LifetimeRef& r)
 
 ::HIR::Pattern LowerHIR_Pattern(const ::AST::Pattern& pat)
 {
-    TRACE_FUNCTION_F("@" << pat.span().filename << ":" << pat.span().start_line << " pat = " << pat);
+    TRACE_FUNCTION_F("@" << pat.span() << " pat = " << pat);
 
     ::HIR::PatternBinding   binding;
     if( pat.binding().is_valid() )
@@ -1971,6 +1971,8 @@ public:
         auto crate_file = (p == ::std::string::npos ? ext_crate.second.m_filename : ext_crate.second.m_filename.substr(p+1));
         rv.m_ext_crates.insert( ::std::make_pair( ext_crate.first, ::HIR::ExternCrate { mv$(ext_crate.second.m_hir), crate_file, ext_crate.second.m_filename } ) );
     }
+    // Extern crates are fixed from here on, index their impls for trait/method lookup
+    rv.build_ext_impl_index();
     path_Sized = rv.get_lang_item_path(sp, "sized");
 
     rv.m_root_module = LowerHIR_Module( crate.m_root_module, ::HIR::ItemPath(rv.m_crate_name) );
@@ -606,6 +606,55 @@ public:
     ::std::map< ::HIR::SimplePath, ImplGroup<::HIR::TraitImpl> > m_trait_impls;
     ::std::map< ::HIR::SimplePath, ImplGroup<::HIR::MarkerImpl> > m_marker_impls;
 
+    /// Key into an `ExtImplIndex`: the trait (null for inherent impls) and the head type constructor of the impl type
+    struct ImplIndexKey
+    {
+        const ::HIR::SimplePath*    trait;
+        // - `TAG_Path` with `path` set for types with a sort path
+        // - `TAG_Primitive` with `core_type` set for primitives
+        // - `TAG_Generic` for the unsorted (generic) impls
+        // - `TAG_Infer` for all primitive/structural impls (used when the queried head isn't known)
+        ::HIR::TypeRef::Data::Tag   tag;
+        ::HIR::CoreType core_type;
+        const ::HIR::SimplePath*    path;
+
+        static ImplIndexKey for_query(const ::HIR::SimplePath* trait, const ::HIR::TypeRef& ty);
+        static ImplIndexKey generic(const ::HIR::SimplePath* trait) {
+            return ImplIndexKey { trait, ::HIR::TypeRef::Data::TAG_Generic, ::HIR::CoreType::Bool, nullptr };
+        }
+        static ImplIndexKey any_unnamed(const ::HIR::SimplePath* trait) {
+            return ImplIndexKey { trait, ::HIR::TypeRef::Data::TAG_Infer, ::HIR::CoreType::Bool, nullptr };
+        }
+
+        bool operator==(const ImplIndexKey& x) const;
+        struct Hash {
+            size_t operator()(const ImplIndexKey& k) const;
+        };
+    };
+    /// Merged impl lists of all loaded extern crates, keyed on (trait, head type)
+    ///
+    /// Extern crates don't change once loaded, so this is built once (see `build_ext_impl_index`) and only read from then
+    /// on. Each entry records the index of its source crate, so lookups can visit impls in the same order as a per-crate
+    /// search would (named/primitive impls then generic impls, crate by crate).
+    template<typename T>
+    struct ExtImplIndex
+    {
+        struct Entry {
+            unsigned    crate_idx;
+            const T*    impl;
+        };
+        typedef ::std::vector<Entry>    list_t;
+        ::std::unordered_map<ImplIndexKey, list_t, ImplIndexKey::Hash>  lists;
+
+        const list_t* get(const ImplIndexKey& key) const {
+            auto it = lists.find(key);
+            return it != lists.end() ? &it->second : nullptr;
+        }
+    };
+    ExtImplIndex<::HIR::TypeImpl>   m_ext_type_impls;
+    ExtImplIndex<::HIR::TraitImpl>  m_ext_trait_impls;
+    ExtImplIndex<::HIR::MarkerImpl> m_ext_marker_impls;
+
     /// Macros exported by this crate
     ::std::unordered_map< RcString, ::MacroRulesPtr >  m_exported_macros;
     /// Macros re-exported by this crate
@@ -630,6 +679,9 @@ public:
     /// Method called to populate runtime state after deserialisation
     /// See hir/crate_post_load.cpp
     void post_load_update(const RcString& loaded_name);
+    /// Populate `m_ext_*_impls` from the impls in `m_ext_crates` (call once all extern crates are loaded)
+    /// See hir/hir_ops.cpp
+    void build_ext_impl_index();
 
     const ::HIR::SimplePath& get_lang_item_path(const Span& sp, const char* name) const;
     const ::HIR::SimplePath& get_lang_item_path_opt(const char* name) const;
@@ -938,6 +938,141 @@ bool ::HIR::TraitImpl::overlaps_with(const Crate& crate, const ::HIR::TraitImpl&
     }
 }
 
+::HIR::Crate::ImplIndexKey HIR::Crate::ImplIndexKey::for_query(const ::HIR::SimplePath* trait, const ::HIR::TypeRef& ty)
+{
+    if( const auto* p = ty.get_sort_path() )
+    {
+        return ImplIndexKey { trait, ::HIR::TypeRef::Data::TAG_Path, ::HIR::CoreType::Bool, p };
+    }
+    switch(ty.m_data.tag())
+    {
+    case ::HIR::TypeRef::Data::TAG_Primitive:
+        return ImplIndexKey { trait, ::HIR::TypeRef::Data::TAG_Primitive, ty.m_data.as_Primitive(), nullptr };
+    // Structural types can only match impls with the same outer type (see `matches_type_int`)
+    case ::HIR::TypeRef::Data::TAG_Diverge:
+    case ::HIR::TypeRef::Data::TAG_Array:
+    case ::HIR::TypeRef::Data::TAG_Slice:
+    case ::HIR::TypeRef::Data::TAG_Tuple:
+    case ::HIR::TypeRef::Data::TAG_Borrow:
+    case ::HIR::TypeRef::Data::TAG_Pointer:
+    case ::HIR::TypeRef::Data::TAG_Function:
+    case ::HIR::TypeRef::Data::TAG_Closure:
+        return ImplIndexKey { trait, ty.m_data.tag(), ::HIR::CoreType::Bool, nullptr };
+    default:
+        // Ivars, generics and unbound paths could match any of the unnamed impls
+        return any_unnamed(trait);
+    }
+}
+bool HIR::Crate::ImplIndexKey::operator==(const ImplIndexKey& x) const
+{
+    if( (trait == nullptr) != (x.trait == nullptr) )
+        return false;
+    if( trait && *trait != *x.trait )
+        return false;
+    if( tag != x.tag )
+        return false;
+    if( tag == ::HIR::TypeRef::Data::TAG_Primitive && core_type != x.core_type )
+        return false;
+    if( tag == ::HIR::TypeRef::Data::TAG_Path && *path != *x.path )
+        return false;
+    return true;
+}
+size_t HIR::Crate::ImplIndexKey::Hash::operator()(const ImplIndexKey& k) const
+{
+    size_t rv = k.trait ? k.trait->hash() : 0;
+    rv = hash_combine(rv, static_cast<size_t>(k.tag));
+    if( k.tag == ::HIR::TypeRef::Data::TAG_Primitive )
+        rv = hash_combine(rv, static_cast<size_t>(k.core_type));
+    if( k.tag == ::HIR::TypeRef::Data::TAG_Path )
+        rv = hash_combine(rv, k.path->hash());
+    return rv;
+}
+
+namespace
+{
+    template<typename T>
+    void add_ext_impl_group(::HIR::Crate::ExtImplIndex<T>& index, unsigned crate_idx, const ::HIR::SimplePath* trait, const ::HIR::Crate::ImplGroup<T>& ig)
+    {
+        typedef ::HIR::Crate::ImplIndexKey  Key;
+        for(const auto& named : ig.named)
+        {
+            auto& list = index.lists[ Key { trait, ::HIR::TypeRef::Data::TAG_Path, ::HIR::CoreType::Bool, &named.first } ];
+            for(const auto& impl : named.second)
+                list.push_back({ crate_idx, impl.get() });
+        }
+        for(const auto& impl : ig.non_named)
+        {
+            index.lists[ Key::any_unnamed(trait) ].push_back({ crate_idx, impl.get() });
+            auto key = Key::for_query(trait, impl->m_type);
+            if( key.tag != ::HIR::TypeRef::Data::TAG_Infer )
+            {
+                assert(key.tag != ::HIR::TypeRef::Data::TAG_Path);
+                index.lists[key].push_back({ crate_idx, impl.get() });
+            }
+        }
+        if( !ig.generic.empty() )
+        {
+            auto& list = index.lists[ Key::generic(trait) ];
+            for(const auto& impl : ig.generic)
+                list.push_back({ crate_idx, impl.get() });
+        }
+    }
+}
+void ::HIR::Crate::build_ext_impl_index()
+{
+    TRACE_FUNCTION;
+    m_ext_type_impls.lists.clear();
+    m_ext_trait_impls.lists.clear();
+    m_ext_marker_impls.lists.clear();
+    // NOTE: Crate indexes follow `m_ext_crates` iteration order, so lookups visit crates in a stable order
+    unsigned crate_idx = 0;
+    for( const auto& ec : this->m_ext_crates )
+    {
+        const auto& crate = *ec.second.m_data;
+        add_ext_impl_group(m_ext_type_impls, crate_idx, nullptr, crate.m_type_impls);
+        for(const auto& ig : crate.m_trait_impls)
+            add_ext_impl_group(m_ext_trait_impls, crate_idx, &ig.first, ig.second);
+        for(const auto& ig : crate.m_marker_impls)
+            add_ext_impl_group(m_ext_marker_impls, crate_idx, &ig.first, ig.second);
+        crate_idx ++;
+    }
+    DEBUG(m_ext_type_impls.lists.size() << " type impl lists, " << m_ext_trait_impls.lists.size() << " trait impl lists, "
+        << m_ext_marker_impls.lists.size() << " marker impl lists");
+}
+
+namespace
+{
+    /// Search the extern crate impl index for impls of `trait` (null for inherent impls) matching `type`
+    template<typename ImplType>
+    bool find_impls_ext(const ::HIR::Crate::ExtImplIndex<ImplType>& index, const ::HIR::SimplePath* trait, const ::HIR::TypeRef& type, ::HIR::t_cb_resolve_type ty_res, ::std::function<bool(const ImplType&)> callback)
+    {
+        static const typename ::HIR::Crate::ExtImplIndex<ImplType>::list_t   empty;
+        const auto* list_a = index.get( ::HIR::Crate::ImplIndexKey::for_query(trait, type) );
+        const auto* list_b = index.get( ::HIR::Crate::ImplIndexKey::generic(trait) );
+        const auto& a = list_a ? *list_a : empty;
+        const auto& b = list_b ? *list_b : empty;
+        // Merge the two lists on crate index, so each crate's type-specific impls are visited before its generic impls
+        auto it_a = a.begin();
+        auto it_b = b.begin();
+        while( it_a != a.end() || it_b != b.end() )
+        {
+            const ImplType* impl;
+            if( it_b == b.end() || (it_a != a.end() && it_a->crate_idx <= it_b->crate_idx) )
+                impl = (it_a++)->impl;
+            else
+                impl = (it_b++)->impl;
+            if( impl->matches_type(type, ty_res) )
+            {
+                if( callback(*impl) )
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+}
+
 namespace
 {
     template<typename ImplType>
@@ -988,14 +1123,7 @@ bool ::HIR::Crate::find_trait_impls(const ::HIR::SimplePath& trait, const ::HIR:
     {
         return true;
     }
-    for( const auto& ec : this->m_ext_crates )
-    {
-        if( find_trait_impls_int(*ec.second.m_data, trait, type, ty_res, callback) )
-        {
-            return true;
-        }
-    }
-    return false;
+    return find_impls_ext(m_ext_trait_impls, &trait, type, ty_res, callback);
 }
 namespace
 {
@@ -1028,14 +1156,7 @@ bool ::HIR::Crate::find_auto_trait_impls(const ::HIR::SimplePath& trait, const :
     {
         return true;
     }
-    for( const auto& ec : this->m_ext_crates )
-    {
-        if( find_auto_trait_impls_int(*ec.second.m_data, trait, type, ty_res, callback) )
-        {
-            return true;
-        }
-    }
-    return false;
+    return find_impls_ext(m_ext_marker_impls, &trait, type, ty_res, callback);
 }
 namespace
 {
@@ -1062,15 +1183,8 @@ bool ::HIR::Crate::find_type_impls(const ::HIR::TypeRef& type, t_cb_resolve_type
     {
         return true;
     }
-    for( const auto& ec : this->m_ext_crates )
-    {
-        //DEBUG("- " << ec.first);
-        if( find_type_impls_int(*ec.second.m_data, type, ty_res, callback) )
-        {
-            return true;
-        }
-    }
-    return false;
+    // > Extern crates
+    return find_impls_ext(m_ext_type_impls, nullptr, type, ty_res, callback);
 }
 
 const ::MIR::Function* HIR::Crate::get_or_gen_mir(const ::HIR::ItemPath& ip, const ::HIR::ExprPtr& ep, const ::HIR::Function::args_t& args, const ::HIR::TypeRef& ret_ty) const
@@ -10,12 +10,25 @@
 #include "crate_ptr.hpp"
 #include <iostream>
 #include <string>
+#include <vector>
 
 namespace AST {
     class Crate;
 }
+namespace HIR {
+    class TypeRef;
+}
+namespace MIR {
+    class Function;
+    class FunctionPointer;
+}
 
 extern void HIR_Dump(::std::ostream& sink, const ::HIR::Crate& crate);
 extern ::HIR::CratePtr  LowerHIR_FromAST(::AST::Crate crate);
 extern void HIR_Serialise(const ::std::string& filename, const ::HIR::Crate& crate);
+/// Select the `.hir` container format for `HIR_Serialise` ("stream", "mapped", "mapped-z"), returns false if unknown
+extern bool HIR_Serialise_SetContainer(const ::std::string& name);
 extern ::HIR::CratePtr HIR_Deserialise(const ::std::string& filename);
+/// Save/load a monomorphised function for the on-disk MIR cache (loading returns false if the file is missing or for a different `key`)
+extern void HIR_SerialiseMonomorphisedMir(const ::std::string& filename, const ::std::string& key, const ::HIR::TypeRef& ret_ty, const ::std::vector< ::HIR::TypeRef>& arg_tys, const ::MIR::Function& mir);
+extern bool HIR_DeserialiseMonomorphisedMir(const ::std::string& filename, const ::std::string& key, ::HIR::TypeRef& ret_ty, ::std::vector< ::HIR::TypeRef>& arg_tys, ::MIR::FunctionPointer& mir);
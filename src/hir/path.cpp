@@ -104,6 +104,13 @@ namespace HIR {
 {
     return SimplePath( m_crate_name, m_components );
 }
+size_t HIR::SimplePath::hash() const
+{
+    size_t  rv = ::std::hash<RcString>()(m_crate_name);
+    for(const auto& c : m_components)
+        rv = hash_combine(rv, ::std::hash<RcString>()(c));
+    return rv;
+}
 
 ::HIR::PathParams::PathParams()
 {
@@ -128,6 +135,13 @@ bool ::HIR::PathParams::operator==(const ::HIR::PathParams& x) const
             return false;
     return true;
 }
+size_t HIR::PathParams::hash() const
+{
+    size_t  rv = m_types.size();
+    for(const auto& t : m_types)
+        rv = hash_combine(rv, t.hash());
+    return rv;
+}
 
 ::HIR::GenericPath::GenericPath()
 {
@@ -151,6 +165,10 @@ bool ::HIR::GenericPath::operator==(const GenericPath& x) const
         return false;
     return m_params == x.m_params;
 }
+size_t HIR::GenericPath::hash() const
+{
+    return hash_combine(m_path.hash(), m_params.hash());
+}
 
 ::HIR::TraitPath HIR::TraitPath::clone() const
 {
@@ -184,6 +202,18 @@ bool ::HIR::TraitPath::operator==(const ::HIR::TraitPath& x) const
     }
     return true;
 }
+size_t HIR::TraitPath::hash() const
+{
+    size_t  rv = m_path.hash();
+    for(const auto& l : m_hrls)
+        rv = hash_combine(rv, ::std::hash<RcString>()(l));
+    for(const auto& b : m_type_bounds)
+    {
+        rv = hash_combine(rv, ::std::hash<RcString>()(b.first));
+        rv = hash_combine(rv, b.second.hash());
+    }
+    return rv;
+}
 
 ::HIR::Path::Path(::HIR::GenericPath gp):
     m_data( ::HIR::Path::Data::make_Generic( mv$(gp) ) )
@@ -408,4 +438,30 @@ Ordering HIR::Path::ord(const ::HIR::Path& x) const
 bool ::HIR::Path::operator==(const Path& x) const {
     return this->ord(x) == ::OrdEqual;
 }
+size_t HIR::Path::hash() const
+{
+    size_t  rv = static_cast<size_t>(m_data.tag());
+    TU_MATCH_HDRA( (m_data), {)
+    TU_ARMA(Generic, e) {
+        rv = hash_combine(rv, e.hash());
+        }
+    TU_ARMA(UfcsInherent, e) {
+        rv = hash_combine(rv, e.type->hash());
+        rv = hash_combine(rv, ::std::hash<RcString>()(e.item));
+        rv = hash_combine(rv, e.params.hash());
+        }
+    TU_ARMA(UfcsKnown, e) {
+        rv = hash_combine(rv, e.type->hash());
+        rv = hash_combine(rv, e.trait.hash());
+        rv = hash_combine(rv, ::std::hash<RcString>()(e.item));
+        rv = hash_combine(rv, e.params.hash());
+        }
+    TU_ARMA(UfcsUnknown, e) {
+        rv = hash_combine(rv, e.type->hash());
+        rv = hash_combine(rv, ::std::hash<RcString>()(e.item));
+        rv = hash_combine(rv, e.params.hash());
+        }
+    }
+    return rv;
+}
 
@@ -91,6 +91,8 @@ struct SimplePath
         rv = ::ord(m_components, x.m_components);
         return rv;
     }
+    /// Structural hash, consistent with `operator==`
+    size_t hash() const;
     friend ::std::ostream& operator<<(::std::ostream& os, const SimplePath& x);
 };
 
@@ -123,6 +125,7 @@ struct PathParams
     Ordering ord(const PathParams& x) const {
         return ::ord(m_types, x.m_types);
     }
+    size_t hash() const;
 
     friend ::std::ostream& operator<<(::std::ostream& os, const PathParams& x);
 };
@@ -150,6 +153,7 @@ public:
         if(rv != OrdEqual)  return rv;
         return ::ord(m_params, x.m_params);
     }
+    size_t hash() const;
 
     friend ::std::ostream& operator<<(::std::ostream& os, const GenericPath& x);
 };
@@ -176,6 +180,7 @@ public:
         ORD(m_hrls, x.m_hrls);
         return ::ord(m_type_bounds, x.m_type_bounds);
     }
+    size_t hash() const;
 
     friend ::std::ostream& operator<<(::std::ostream& os, const TraitPath& x);
 };
@@ -227,11 +232,27 @@ public:
     bool operator==(const Path& x) const;
     bool operator!=(const Path& x) const { return !(*this == x); }
     bool operator<(const Path& x) const { return ord(x) == OrdLess; }
+    size_t hash() const;
 
     friend ::std::ostream& operator<<(::std::ostream& os, const Path& x);
 };
 
 }   // namespace HIR
 
+namespace std {
+    template<> struct hash< ::HIR::SimplePath> {
+        size_t operator()(const ::HIR::SimplePath& x) const noexcept { return x.hash(); }
+    };
+    template<> struct hash< ::HIR::PathParams> {
+        size_t operator()(const ::HIR::PathParams& x) const noexcept { return x.hash(); }
+    };
+    template<> struct hash< ::HIR::GenericPath> {
+        size_t operator()(const ::HIR::GenericPath& x) const noexcept { return x.hash(); }
+    };
+    template<> struct hash< ::HIR::Path> {
+        size_t operator()(const ::HIR::Path& x) const noexcept { return x.hash(); }
+    };
+}
+
 #endif
 
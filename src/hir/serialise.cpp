@@ -612,7 +612,10 @@
         {
             m_out.write_bool( (bool)exp.m_mir && save_mir );
             if( exp.m_mir && save_mir ) {
+                // Length-prefixed, so loading can defer decoding until the body is used
+                m_out.start_blob();
                 serialise(*exp.m_mir);
+                m_out.end_blob();
             }
             serialise_vec( exp.m_erased_types );
         }
@@ -1127,12 +1130,46 @@
     };
 //}
 
+namespace {
+    ::HIR::serialise::Container g_hir_container = ::HIR::serialise::Container::Stream;
+}
+
+bool HIR_Serialise_SetContainer(const ::std::string& name)
+{
+    if( name == "stream" )
+        g_hir_container = ::HIR::serialise::Container::Stream;
+    else if( name == "mapped" )
+        g_hir_container = ::HIR::serialise::Container::Mapped;
+    else if( name == "mapped-z" )
+        g_hir_container = ::HIR::serialise::Container::MappedCompressed;
+    else
+        return false;
+    return true;
+}
+
 void HIR_Serialise(const ::std::string& filename, const ::HIR::Crate& crate)
 {
     ::HIR::serialise::Writer    out;
     HirSerialiser  s { out };
     s.serialise_crate(crate);
-    out.open(filename);
+    out.open(filename, g_hir_container);
     s.serialise_crate(crate);
+    out.close();
 }
 
+
+void HIR_SerialiseMonomorphisedMir(const ::std::string& filename, const ::std::string& key, const ::HIR::TypeRef& ret_ty, const ::std::vector< ::HIR::TypeRef>& arg_tys, const ::MIR::Function& mir)
+{
+    ::HIR::serialise::Writer    out;
+    HirSerialiser  s { out };
+    auto save = [&]() {
+        out.write_string(key);
+        s.serialise_type(ret_ty);
+        s.serialise_vec(arg_tys);
+        s.serialise(mir);
+        };
+    save();
+    out.open(filename);
+    save();
+    out.close();
+}
@@ -12,6 +12,15 @@
 #include <string.h>   // memcpy
 #include <common.hpp>
 #include <algorithm>
+#ifdef _WIN32
+# define WIN32_LEAN_AND_MEAN
+# include <Windows.h>
+#else
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
 
 namespace HIR {
 namespace serialise {
@@ -24,21 +33,221 @@ class WriterInner
 
     unsigned int    m_byte_out_count = 0;
     unsigned int    m_byte_in_count = 0;
+    bool    m_finished = false;
 public:
     WriterInner(const ::std::string& filename);
     ~WriterInner();
     void write(const void* buf, size_t len);
+    /// Complete the compressed stream and check that the file was written
+    void finish();
 };
 
+namespace {
+    // Mapped container layout (all integers little-endian):
+    // - 8 byte magic (can't be confused with a zlib header, which starts with 0x78)
+    // - u32 section count
+    // - Section table: { u32 id, u32 flags, u64 offset, u64 stored_size, u64 size }
+    // - Section data, each aligned to 8 bytes
+    const char CONTAINER_MAGIC[8] = { 'M','R','S','T','H','I','R','\x01' };
+    enum SectionId : uint32_t {
+        SECTION_STRINGS = 1,
+        SECTION_ITEMS = 2,
+        SECTION_MIR = 3,
+    };
+    const uint32_t SECTION_FLAG_ZLIB = 1;
+    const size_t SECTION_HEADER_SIZE = 4+4+8+8+8;
+
+    void put_u32(::std::vector<uint8_t>& out, uint32_t v) {
+        for(int i = 0; i < 4; i ++)
+            out.push_back( static_cast<uint8_t>(v >> (i*8)) );
+    }
+    void put_u64(::std::vector<uint8_t>& out, uint64_t v) {
+        for(int i = 0; i < 8; i ++)
+            out.push_back( static_cast<uint8_t>(v >> (i*8)) );
+    }
+    uint32_t get_u32(const uint8_t* p) {
+        uint32_t rv = 0;
+        for(int i = 0; i < 4; i ++)
+            rv |= static_cast<uint32_t>(p[i]) << (i*8);
+        return rv;
+    }
+    uint64_t get_u64(const uint8_t* p) {
+        uint64_t rv = 0;
+        for(int i = 0; i < 8; i ++)
+            rv |= static_cast<uint64_t>(p[i]) << (i*8);
+        return rv;
+    }
+
+    /// Read-only view of an entire file
+    class MappedFile
+    {
+        const uint8_t*  m_data;
+        size_t  m_size;
+    public:
+        MappedFile(const ::std::string& filename);
+        MappedFile(const MappedFile&) = delete;
+        ~MappedFile();
+
+        const uint8_t* data() const { return m_data; }
+        size_t size() const { return m_size; }
+    };
+#ifdef _WIN32
+    MappedFile::MappedFile(const ::std::string& filename)
+    {
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if( file == INVALID_HANDLE_VALUE )
+            throw ::std::runtime_error("Unable to open file");
+        LARGE_INTEGER   size;
+        if( !GetFileSizeEx(file, &size) ) {
+            CloseHandle(file);
+            throw ::std::runtime_error("Unable to stat file");
+        }
+        m_size = static_cast<size_t>(size.QuadPart);
+        m_data = nullptr;
+        // NOTE: Empty files can't be mapped
+        if( m_size > 0 )
+        {
+            HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+            CloseHandle(file);
+            if( mapping == NULL )
+                throw ::std::runtime_error("Unable to map file");
+            void* p = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            // The view keeps the mapping alive
+            CloseHandle(mapping);
+            if( p == NULL )
+                throw ::std::runtime_error("Unable to map file");
+            m_data = static_cast<const uint8_t*>(p);
+        }
+        else
+        {
+            CloseHandle(file);
+        }
+    }
+    MappedFile::~MappedFile()
+    {
+        if( m_data )
+            UnmapViewOfFile(m_data);
+    }
+#else
+    MappedFile::MappedFile(const ::std::string& filename)
+    {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if( fd < 0 )
+            throw ::std::runtime_error("Unable to open file");
+        struct stat st;
+        if( fstat(fd, &st) != 0 ) {
+            ::close(fd);
+            throw ::std::runtime_error("Unable to stat file");
+        }
+        m_size = st.st_size;
+        void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if( p == MAP_FAILED )
+            throw ::std::runtime_error("Unable to map file");
+        m_data = static_cast<const uint8_t*>(p);
+    }
+    MappedFile::~MappedFile()
+    {
+        ::munmap( const_cast<uint8_t*>(m_data), m_size );
+    }
+#endif
+
+    bool is_mapped_container(const ::std::string& filename)
+    {
+        char buf[sizeof CONTAINER_MAGIC];
+        ::std::ifstream is(filename, ::std::ios_base::in|::std::ios_base::binary);
+        if( !is.is_open() )
+            throw ::std::runtime_error("Unable to open file");
+        is.read(buf, sizeof buf);
+        return is.gcount() == sizeof buf && memcmp(buf, CONTAINER_MAGIC, sizeof buf) == 0;
+    }
+
+    void write_mapped_container(const ::std::string& filename, bool compress, const ::std::vector<uint8_t>& strings, const ::std::vector<uint8_t>& items, const ::std::vector<uint8_t>& mir)
+    {
+        struct Section {
+            SectionId   id;
+            const ::std::vector<uint8_t>&   data;
+            bool    compress;
+            ::std::vector<uint8_t>  compressed;
+        };
+        // MIR bodies are never compressed, so they can be decoded directly from the mapping
+        Section sections[] = {
+            { SECTION_STRINGS, strings, compress, {} },
+            { SECTION_ITEMS, items, compress, {} },
+            { SECTION_MIR, mir, false, {} },
+        };
+        for(auto& s : sections)
+        {
+            if( !s.compress )
+                continue ;
+            uLongf  len = compressBound(s.data.size());
+            s.compressed.resize(len);
+            if( compress2(s.compressed.data(), &len, s.data.data(), s.data.size(), Z_BEST_COMPRESSION) != Z_OK )
+                throw ::std::runtime_error("zlib compress failure");
+            s.compressed.resize(len);
+        }
+
+        ::std::vector<uint8_t>  header;
+        header.insert(header.end(), CONTAINER_MAGIC, CONTAINER_MAGIC + sizeof CONTAINER_MAGIC);
+        put_u32(header, sizeof sections / sizeof sections[0]);
+        uint64_t ofs = header.size() + SECTION_HEADER_SIZE * (sizeof sections / sizeof sections[0]);
+        for(const auto& s : sections)
+        {
+            ofs = (ofs + 7) & ~uint64_t(7);
+            const auto& stored = s.compress ? s.compressed : s.data;
+            put_u32(header, s.id);
+            put_u32(header, s.compress ? SECTION_FLAG_ZLIB : 0);
+            put_u64(header, ofs);
+            put_u64(header, stored.size());
+            put_u64(header, s.data.size());
+            ofs += stored.size();
+        }
+
+        ::std::ofstream os(filename, ::std::ios_base::out | ::std::ios_base::binary);
+        os.write(reinterpret_cast<const char*>(header.data()), header.size());
+        size_t pos = header.size();
+        for(const auto& s : sections)
+        {
+            static const char zeroes[8] = {};
+            const auto& stored = s.compress ? s.compressed : s.data;
+            os.write(zeroes, ((pos + 7) & ~size_t(7)) - pos);
+            pos = (pos + 7) & ~size_t(7);
+            os.write(reinterpret_cast<const char*>(stored.data()), stored.size());
+            pos += stored.size();
+        }
+        if( !os.good() )
+            throw ::std::runtime_error("Error writing metadata file");
+    }
+}
+
 Writer::Writer():
-    m_inner(nullptr)
+    m_inner(nullptr),
+    m_container(Container::Stream),
+    m_is_open(false),
+    m_cur_section(nullptr)
 {
 }
 Writer::~Writer()
 {
+    // NOTE: Doesn't write anything, if `close` wasn't called then the output was abandoned (e.g. by an exception)
     delete m_inner, m_inner = nullptr;
 }
-void Writer::open(const ::std::string& filename)
+void Writer::close()
+{
+    if( !m_is_open )
+        return ;
+    m_is_open = false;
+    if( m_inner )
+    {
+        m_inner->finish();
+        delete m_inner, m_inner = nullptr;
+    }
+    else
+    {
+        write_mapped_container(m_filename, m_container == Container::MappedCompressed, m_sec_strings, m_sec_items, m_sec_mir);
+    }
+}
+void Writer::open(const ::std::string& filename, Container container)
 {
     // 1. Sort strings by frequency
     ::std::vector<::std::pair<RcString, unsigned>> sorted;
@@ -48,7 +257,15 @@ void Writer::open(const ::std::string& filename)
     // 2. Write out string table
     ::std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b){ return a.second > b.second; });
 
-    m_inner = new WriterInner(filename);
+    m_container = container;
+    m_filename = filename;
+    m_is_open = true;
+    if( container == Container::Stream ) {
+        m_inner = new WriterInner(filename);
+    }
+    else {
+        m_cur_section = &m_sec_strings;
+    }
     // 3. Reset m_istring_cache to use the same value
     this->write_count(sorted.size());
     for(size_t i = 0; i < sorted.size(); i ++)
@@ -62,19 +279,49 @@ void Writer::open(const ::std::string& filename)
     {
         assert(e.second < sorted.size());
     }
+    if( container != Container::Stream ) {
+        m_cur_section = &m_sec_items;
+    }
 }
 void Writer::write(const void* buf, size_t len)
 {
-    if( m_inner ) {
-        m_inner->write(buf, len);
+    if( !m_is_open ) {
+        // No-op, pre caching
+    }
+    else if( !m_blobs.empty() || m_cur_section ) {
+        auto& dst = m_blobs.empty() ? *m_cur_section : m_blobs.back();
+        auto* p = reinterpret_cast<const uint8_t*>(buf);
+        dst.insert(dst.end(), p, p + len);
     }
     else {
-        // No-op, pre caching
+        m_inner->write(buf, len);
+    }
+}
+void Writer::start_blob()
+{
+    m_blobs.push_back({});
+}
+void Writer::end_blob()
+{
+    assert(!m_blobs.empty());
+    auto blob = ::std::move(m_blobs.back());
+    m_blobs.pop_back();
+    if( m_cur_section )
+    {
+        // Mapped: Data goes into the MIR section, and the location is recorded inline
+        this->write_u64c(m_sec_mir.size());
+        this->write_u64c(blob.size());
+        m_sec_mir.insert(m_sec_mir.end(), blob.begin(), blob.end());
+    }
+    else
+    {
+        this->write_u64c(blob.size());
+        this->write(blob.data(), blob.size());
     }
 }
 void Writer::write_string(const RcString& v)
 {
-    if( m_inner ) {
+    if( m_is_open ) {
         // Emit ID from the cache
         this->write_count( m_istring_cache.at(v) );
     }
@@ -105,17 +352,21 @@ WriterInner::WriterInner(const ::std::string& filename):
 }
 WriterInner::~WriterInner()
 {
+    deflateEnd(&m_zstream);
+}
+void WriterInner::finish()
+{
+    assert( !m_finished );
     assert( m_zstream.avail_in == 0 );
+    m_finished = true;
 
     // Complete the compression
     int ret;
     do
     {
         ret = deflate(&m_zstream, Z_FINISH);
-        if(ret == Z_STREAM_ERROR) {
-            ::std::cerr << "ERROR: zlib deflate stream error (cleanup)";
-            abort();
-        }
+        if(ret == Z_STREAM_ERROR)
+            throw ::std::runtime_error("zlib deflate stream error (cleanup)");
         if( m_zstream.avail_out != m_buffer.size() )
         {
             size_t rem = m_buffer.size() - m_zstream.avail_out;
@@ -126,7 +377,9 @@ WriterInner::~WriterInner()
             m_zstream.next_out = m_buffer.data();
         }
     } while(ret == Z_OK);
-    deflateEnd(&m_zstream);
+    m_backing.flush();
+    if( !m_backing.good() )
+        throw ::std::runtime_error("Error writing metadata file");
 }
 
 void WriterInner::write(const void* buf, size_t len)
@@ -197,23 +450,32 @@ public:
 
 
 ReadBuffer::ReadBuffer(size_t cap):
+    m_data(nullptr),
+    m_size(0),
     m_ofs(0)
 {
     m_backing.reserve(cap);
 }
+ReadBuffer::ReadBuffer(Blob data):
+    m_owner( ::std::move(data.owner) ),
+    m_data(data.data),
+    m_size(data.size),
+    m_ofs(0)
+{
+}
 size_t ReadBuffer::read(void* dst, size_t len)
 {
-    size_t rem = m_backing.size() - m_ofs;
+    size_t rem = m_size - m_ofs;
     if( rem >= len )
     {
-        memcpy(dst, m_backing.data() + m_ofs, len);
+        memcpy(dst, m_data + m_ofs, len);
         m_ofs += len;
         return len;
     }
     else
     {
-        memcpy(dst, m_backing.data() + m_ofs, rem);
-        m_ofs = m_backing.size();
+        memcpy(dst, m_data + m_ofs, rem);
+        m_ofs = m_size;
         return rem;
     }
 }
@@ -222,24 +484,98 @@ void ReadBuffer::populate(ReaderInner& is)
     m_backing.resize( m_backing.capacity(), 0 );
     auto len = is.read(m_backing.data(), m_backing.size());
     m_backing.resize( len );
+    m_data = m_backing.data();
+    m_size = len;
     m_ofs = 0;
 }
 
 
 Reader::Reader(const ::std::string& filename):
-    m_inner( new ReaderInner(filename) ),
+    m_inner(nullptr),
     m_buffer(1024),
     m_pos(0)
 {
+    auto tables = ::std::make_shared<ReaderTables>();
+    Blob    items;
+    if( is_mapped_container(filename) )
+    {
+        auto file = ::std::make_shared<MappedFile>(filename);
+        const uint8_t* base = file->data();
+        size_t n_sections = file->size() >= sizeof CONTAINER_MAGIC + 4 ? get_u32(base + sizeof CONTAINER_MAGIC) : 0;
+        const uint8_t* hdr = base + sizeof CONTAINER_MAGIC + 4;
+        if( n_sections > (file->size() - (sizeof CONTAINER_MAGIC + 4)) / SECTION_HEADER_SIZE )
+            throw ::std::runtime_error("Truncated section table");
+
+        Blob    strings;
+        for(size_t i = 0; i < n_sections; i ++, hdr += SECTION_HEADER_SIZE)
+        {
+            auto id = get_u32(hdr + 0);
+            auto flags = get_u32(hdr + 4);
+            auto ofs = get_u64(hdr + 8);
+            auto stored_size = get_u64(hdr + 16);
+            auto size = get_u64(hdr + 24);
+            if( ofs > file->size() || stored_size > file->size() - ofs )
+                throw ::std::runtime_error( FMT("Section " << id << " is out of bounds") );
+
+            Blob    sec;
+            if( flags & SECTION_FLAG_ZLIB )
+            {
+                auto buf = ::std::make_shared<::std::vector<uint8_t>>(size);
+                uLongf  len = size;
+                if( uncompress(buf->data(), &len, base + ofs, stored_size) != Z_OK || len != size )
+                    throw ::std::runtime_error( FMT("Unable to decompress section " << id) );
+                sec.data = buf->data();
+                sec.size = size;
+                sec.owner = ::std::move(buf);
+            }
+            else
+            {
+                sec.data = base + ofs;
+                sec.size = stored_size;
+                sec.owner = file;
+            }
+
+            switch(id)
+            {
+            case SECTION_STRINGS:   strings = ::std::move(sec); break;
+            case SECTION_ITEMS: items = ::std::move(sec);   break;
+            case SECTION_MIR:   tables->mir = ::std::move(sec); break;
+            default:
+                // Unknown sections are ignored (allows adding optional sections later)
+                break;
+            }
+        }
+        tables->is_mapped = true;
+        m_buffer = ReadBuffer(::std::move(strings));
+    }
+    else
+    {
+        m_inner = new ReaderInner(filename);
+    }
+
     size_t n_strings = read_count();
-    m_strings.reserve(n_strings);
+    ::std::vector<::std::string>    strings;
+    strings.reserve(n_strings);
     DEBUG("n_strings = " << n_strings);
     for(size_t i = 0; i < n_strings; i ++)
     {
-        auto s = read_string();
-        m_strings.push_back( RcString::new_interned(s) );
+        strings.push_back( read_string() );
+    }
+    tables->strings = RcString::new_interned_list(strings);
+    m_tables = ::std::move(tables);
+
+    if( !m_inner )
+    {
+        m_buffer = ReadBuffer(::std::move(items));
     }
 }
+Reader::Reader(::std::shared_ptr<const ReaderTables> tables, Blob blob):
+    m_inner(nullptr),
+    m_buffer( ::std::move(blob) ),
+    m_pos(0),
+    m_tables( ::std::move(tables) )
+{
+}
 Reader::~Reader()
 {
     delete m_inner, m_inner = nullptr;
@@ -255,6 +591,9 @@ void Reader::read(void* buf, size_t len)
     buf = reinterpret_cast<uint8_t*>(buf) + used;
     len -= used;
 
+    if( !m_inner )
+        throw ::std::runtime_error( FMT("Reader::read - Requested " << len << " bytes past the end of a blob") );
+
     if( len >= m_buffer.capacity() )
     {
         m_inner->read(buf, len);
@@ -269,6 +608,32 @@ void Reader::read(void* buf, size_t len)
 
     m_pos += len;
 }
+Blob Reader::read_blob()
+{
+    Blob    rv;
+    if( m_tables->is_mapped )
+    {
+        // Mapped: Blobs are stored in the MIR section
+        size_t ofs = read_u64c();
+        size_t len = read_u64c();
+        const auto& sec = m_tables->mir;
+        if( ofs > sec.size || len > sec.size - ofs )
+            throw ::std::runtime_error( FMT("Reader::read_blob - Blob " << ofs << "+" << len << " is outside of the MIR section (" << sec.size << " bytes)") );
+        rv.owner = sec.owner;
+        rv.data = sec.data + ofs;
+        rv.size = len;
+    }
+    else
+    {
+        size_t len = read_u64c();
+        auto buf = ::std::make_shared<::std::vector<uint8_t>>(len);
+        read(buf->data(), len);
+        rv.data = buf->data();
+        rv.size = len;
+        rv.owner = ::std::move(buf);
+    }
+    return rv;
+}
 
 
 ReaderInner::ReaderInner(const ::std::string& filename):
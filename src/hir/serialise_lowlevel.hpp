@@ -10,6 +10,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 #include <stddef.h>
 #include <assert.h>
 #include <rc_string.hpp>
@@ -20,19 +21,55 @@ namespace serialise {
 class WriterInner;
 class ReaderInner;
 
+/// On-disk layout of a `.hir` file (auto-detected when reading)
+enum class Container
+{
+    /// A single zlib stream (string table followed by items)
+    Stream,
+    /// Header and section table followed by uncompressed sections, loaded with `mmap`
+    Mapped,
+    /// As `Mapped`, but with the string table and item sections zlib-compressed (MIR bodies are left uncompressed)
+    MappedCompressed,
+};
+
+/// Immutable range of serialised bytes, kept alive by its owner (a mapped file or an owned buffer)
+struct Blob
+{
+    ::std::shared_ptr<const void>   owner;
+    const uint8_t*  data = nullptr;
+    size_t  size = 0;
+};
+
 class Writer
 {
     WriterInner*    m_inner;
+    Container   m_container;
+    bool    m_is_open;
+    ::std::string   m_filename;
     ::std::map<RcString, unsigned>  m_istring_cache;
+    /// Stack of length-prefixed blocks currently being written (see `start_blob`)
+    ::std::vector< ::std::vector<uint8_t> > m_blobs;
+
+    // Section data for the mapped containers (written out by `close`)
+    ::std::vector<uint8_t>  m_sec_strings;
+    ::std::vector<uint8_t>  m_sec_items;
+    ::std::vector<uint8_t>  m_sec_mir;
+    ::std::vector<uint8_t>* m_cur_section;
 public:
     Writer();
     Writer(const Writer&) = delete;
     Writer(Writer&&) = delete;
     ~Writer();
 
-    void open(const ::std::string& filename);
+    void open(const ::std::string& filename, Container container=Container::Stream);
+    /// Finish writing the file (throws on failure). The destructor doesn't write anything, so this must be called.
+    void close();
     void write(const void* data, size_t count);
 
+    /// Start a length-prefixed block of data, which a reader can skip over with `Reader::read_blob`
+    void start_blob();
+    void end_blob();
+
     void write_u8(uint8_t v) {
         write(reinterpret_cast<const char*>(&v), 1);
     }
@@ -141,31 +178,51 @@ public:
 
 class ReadBuffer
 {
+    // Either `m_backing` (when streaming), or a view of a blob
     ::std::vector<uint8_t>  m_backing;
-    unsigned int    m_ofs;
+    ::std::shared_ptr<const void>   m_owner;
+    const uint8_t*  m_data;
+    size_t  m_size;
+    size_t  m_ofs;
 public:
     ReadBuffer(size_t size);
+    ReadBuffer(Blob data);
 
     size_t capacity() const { return m_backing.capacity(); }
     size_t read(void* dst, size_t len);
     void populate(ReaderInner& is);
 };
 
+/// State shared between a reader and readers created for the blobs that it returned
+struct ReaderTables
+{
+    ::std::vector<RcString> strings;
+    /// Set when reading a mapped container (blobs are then offsets into `mir`)
+    bool    is_mapped = false;
+    Blob    mir;
+};
+
 class Reader
 {
     ReaderInner*    m_inner;
     ReadBuffer  m_buffer;
     size_t  m_pos;
-    ::std::vector<RcString> m_strings;
+    ::std::shared_ptr<const ReaderTables>   m_tables;
 public:
     Reader(const ::std::string& path);
+    /// Read from a blob returned by `read_blob`, using the tables from the reader that it came from
+    Reader(::std::shared_ptr<const ReaderTables> tables, Blob blob);
     Reader(const Writer&) = delete;
     Reader(Writer&&) = delete;
     ~Reader();
 
     size_t get_pos() const { return m_pos; }
+    const ::std::shared_ptr<const ReaderTables>& tables() const { return m_tables; }
     void read(void* dst, size_t count);
 
+    /// Read (without decoding) a block written between `Writer::start_blob` and `Writer::end_blob`
+    Blob read_blob();
+
     uint8_t read_u8() {
         uint8_t v;
         read(&v, sizeof v);
@@ -262,7 +319,7 @@ public:
     }
     RcString read_istring() {
         size_t idx = read_count();
-        return m_strings.at(idx);
+        return m_tables->strings.at(idx);
     }
     ::std::string read_string() {
         size_t len = read_u8();
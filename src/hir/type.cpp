@@ -379,6 +379,67 @@ Ordering HIR::TypeRef::ord(const ::HIR::TypeRef& x) const
     )
     throw "";
 }
+size_t HIR::TypeRef::hash() const
+{
+    size_t  rv = static_cast<size_t>(m_data.tag());
+    TU_MATCH_HDRA( (m_data), {)
+    TU_ARMA(Infer, te) {
+        rv = hash_combine(rv, te.index);
+        }
+    TU_ARMA(Diverge, te) {
+        }
+    TU_ARMA(Primitive, te) {
+        rv = hash_combine(rv, static_cast<size_t>(te));
+        }
+    TU_ARMA(Path, te) {
+        rv = hash_combine(rv, te.path.hash());
+        }
+    TU_ARMA(Generic, te) {
+        rv = hash_combine(rv, ::std::hash<RcString>()(te.name));
+        rv = hash_combine(rv, te.binding);
+        }
+    TU_ARMA(TraitObject, te) {
+        rv = hash_combine(rv, te.m_trait.hash());
+        for(const auto& m : te.m_markers)
+            rv = hash_combine(rv, m.hash());
+        }
+    TU_ARMA(ErasedType, te) {
+        // Equality only considers the origin
+        rv = hash_combine(rv, te.m_origin.hash());
+        }
+    TU_ARMA(Array, te) {
+        rv = hash_combine(rv, te.inner->hash());
+        rv = hash_combine(rv, te.size_val);
+        }
+    TU_ARMA(Slice, te) {
+        rv = hash_combine(rv, te.inner->hash());
+        }
+    TU_ARMA(Tuple, te) {
+        for(const auto& t : te)
+            rv = hash_combine(rv, t.hash());
+        }
+    TU_ARMA(Borrow, te) {
+        rv = hash_combine(rv, static_cast<size_t>(te.type));
+        rv = hash_combine(rv, te.inner->hash());
+        }
+    TU_ARMA(Pointer, te) {
+        rv = hash_combine(rv, static_cast<size_t>(te.type));
+        rv = hash_combine(rv, te.inner->hash());
+        }
+    TU_ARMA(Function, te) {
+        rv = hash_combine(rv, te.is_unsafe);
+        rv = hash_combine(rv, ::std::hash<::std::string>()(te.m_abi));
+        for(const auto& t : te.m_arg_types)
+            rv = hash_combine(rv, t.hash());
+        rv = hash_combine(rv, te.m_rettype->hash());
+        }
+    TU_ARMA(Closure, te) {
+        rv = hash_combine(rv, reinterpret_cast<::std::uintptr_t>(te.node));
+        }
+    }
+    return rv;
+}
+
 bool ::HIR::TypeRef::contains_generics() const
 {
     struct H {
@@ -388,6 +449,31 @@ bool ::HIR::TypeRef::contains_generics() const
                     return true;
             return false;
         }
+        static bool path_contains_generics(const ::HIR::Path& p) {
+            TU_MATCH(::HIR::Path::Data, (p.m_data), (tpe),
+            (Generic,
+                return vec_contains_generics( tpe.m_params.m_types );
+                ),
+            (UfcsInherent,
+                return tpe.type->contains_generics() || vec_contains_generics(tpe.params.m_types) || vec_contains_generics(tpe.impl_params.m_types);
+                ),
+            (UfcsKnown,
+                return tpe.type->contains_generics() || vec_contains_generics(tpe.trait.m_params.m_types) || vec_contains_generics(tpe.params.m_types);
+                ),
+            (UfcsUnknown,
+                return tpe.type->contains_generics() || vec_contains_generics(tpe.params.m_types);
+                )
+            )
+            throw "";
+        }
+        static bool trait_contains_generics(const ::HIR::TraitPath& tp) {
+            if( vec_contains_generics(tp.m_path.m_params.m_types) )
+                return true;
+            for(const auto& assoc : tp.m_type_bounds)
+                if( assoc.second.contains_generics() )
+                    return true;
+            return false;
+        }
     };
     TU_MATCH(::HIR::TypeRef::Data, (m_data), (te),
     (Infer,
@@ -400,31 +486,26 @@ bool ::HIR::TypeRef::contains_generics() const
         return false;
         ),
     (Path,
-        TU_MATCH(::HIR::Path::Data, (te.path.m_data), (tpe),
-        (Generic,
-            return H::vec_contains_generics( tpe.m_params.m_types );
-            ),
-        (UfcsInherent,
-            if( tpe.type->contains_generics() )
-                return true;
-            TODO(Span(), "UfcsInherent");
-            ),
-        (UfcsKnown,
-            TODO(Span(), "UfcsKnown");
-            ),
-        (UfcsUnknown,
-            TODO(Span(), "UfcsUnknown");
-            )
-        )
+        return H::path_contains_generics(te.path);
         ),
     (Generic,
         return true;
         ),
     (TraitObject,
-        TODO(Span(), "TraitObject");
+        if( H::trait_contains_generics(te.m_trait) )
+            return true;
+        for(const auto& marker : te.m_markers)
+            if( H::vec_contains_generics(marker.m_params.m_types) )
+                return true;
+        return false;
         ),
     (ErasedType,
-        TODO(Span(), "ErasedType");
+        if( H::path_contains_generics(te.m_origin) )
+            return true;
+        for(const auto& trait : te.m_traits)
+            if( H::trait_contains_generics(trait) )
+                return true;
+        return false;
         ),
     (Array,
         return te.inner->contains_generics();
@@ -332,6 +332,8 @@ public:
     bool operator!=(const ::HIR::TypeRef& x) const { return !(*this == x); }
     bool operator<(const ::HIR::TypeRef& x) const { return ord(x) == OrdLess; }
     Ordering ord(const ::HIR::TypeRef& x) const;
+    /// Structural hash, consistent with `operator==`
+    size_t hash() const;
 
     bool contains_generics() const;
 
@@ -370,5 +372,12 @@ extern ::std::ostream& operator<<(::std::ostream& os, const ::HIR::TypeRef& ty);
 
 }   // namespace HIR
 
+namespace std {
+    template<> struct hash< ::HIR::TypeRef>
+    {
+        size_t operator()(const ::HIR::TypeRef& x) const noexcept { return x.hash(); }
+    };
+}
+
 #endif
 
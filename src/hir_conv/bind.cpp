@@ -709,143 +709,157 @@ namespace {
                 (*expr).visit(v);
             }
             // External expression (has MIR)
+            else if( expr.m_mir.is_pending() )
+            {
+                // Not decoded yet, bind it when it's first used
+                const auto& crate = m_crate;
+                expr.m_mir.on_load([&crate](::MIR::Function& mir) {
+                    Visitor v { crate };
+                    v.visit_ext_mir(mir);
+                    });
+            }
             else if( auto* mir = expr.get_ext_mir_mut() )
             {
-                struct H {
-                    static void visit_lvalue(Visitor& upper_visitor, ::MIR::LValue& lv)
-                    {
-                        if( lv.m_root.is_Static() ) {
-                            upper_visitor.visit_path(lv.m_root.as_Static(), ::HIR::Visitor::PathContext::VALUE);
-                        }
+                visit_ext_mir(*mir);
+            }
+            else
+            {
+            }
+        }
+
+        void visit_ext_mir(::MIR::Function& mir)
+        {
+            struct H {
+                static void visit_lvalue(Visitor& upper_visitor, ::MIR::LValue& lv)
+                {
+                    if( lv.m_root.is_Static() ) {
+                        upper_visitor.visit_path(lv.m_root.as_Static(), ::HIR::Visitor::PathContext::VALUE);
                     }
-                    static void visit_constant(Visitor& upper_visitor, ::MIR::Constant& e)
-                    {
-                        TU_MATCHA( (e), (ce),
-                        (Int, ),
-                        (Uint,),
-                        (Float, ),
-                        (Bool, ),
-                        (Bytes, ),
-                        (StaticString, ),  // String
-                        (Const,
-                            upper_visitor.visit_path(*ce.p, ::HIR::Visitor::PathContext::VALUE);
-                            ),
-                        (ItemAddr,
-                            upper_visitor.visit_path(*ce, ::HIR::Visitor::PathContext::VALUE);
-                            )
+                }
+                static void visit_constant(Visitor& upper_visitor, ::MIR::Constant& e)
+                {
+                    TU_MATCHA( (e), (ce),
+                    (Int, ),
+                    (Uint,),
+                    (Float, ),
+                    (Bool, ),
+                    (Bytes, ),
+                    (StaticString, ),  // String
+                    (Const,
+                        upper_visitor.visit_path(*ce.p, ::HIR::Visitor::PathContext::VALUE);
+                        ),
+                    (ItemAddr,
+                        upper_visitor.visit_path(*ce, ::HIR::Visitor::PathContext::VALUE);
                         )
-                    }
-                    static void visit_param(Visitor& upper_visitor, ::MIR::Param& p)
-                    {
-                        TU_MATCHA( (p), (e),
-                        (LValue, H::visit_lvalue(upper_visitor, e);),
-                        (Constant,
-                            H::visit_constant(upper_visitor, e);
-                            )
+                    )
+                }
+                static void visit_param(Visitor& upper_visitor, ::MIR::Param& p)
+                {
+                    TU_MATCHA( (p), (e),
+                    (LValue, H::visit_lvalue(upper_visitor, e);),
+                    (Constant,
+                        H::visit_constant(upper_visitor, e);
                         )
-                    }
-                };
-                for(auto& ty : mir->locals)
-                    this->visit_type(ty);
-                for(auto& block : mir->blocks)
+                    )
+                }
+            };
+            for(auto& ty : mir.locals)
+                this->visit_type(ty);
+            for(auto& block : mir.blocks)
+            {
+                for(auto& stmt : block.statements)
                 {
-                    for(auto& stmt : block.statements)
-                    {
-                        TU_IFLET(::MIR::Statement, stmt, Assign, se,
-                            H::visit_lvalue(*this, se.dst);
-                            TU_MATCHA( (se.src), (e),
-                            (Use,
-                                H::visit_lvalue(*this, e);
-                                ),
-                            (Constant,
-                                H::visit_constant(*this, e);
-                                ),
-                            (SizedArray,
-                                H::visit_param(*this, e.val);
-                                ),
-                            (Borrow,
-                                H::visit_lvalue(*this, e.val);
-                                ),
-                            (Cast,
-                                H::visit_lvalue(*this, e.val);
-                                this->visit_type(e.type);
-                                ),
-                            (BinOp,
-                                H::visit_param(*this, e.val_l);
-                                H::visit_param(*this, e.val_r);
-                                ),
-                            (UniOp,
-                                H::visit_lvalue(*this, e.val);
-                                ),
-                            (DstMeta,
-                                H::visit_lvalue(*this, e.val);
-                                ),
-                            (DstPtr,
-                                H::visit_lvalue(*this, e.val);
-                                ),
-                            (MakeDst,
-                                H::visit_param(*this, e.ptr_val);
-                                H::visit_param(*this, e.meta_val);
-                                ),
-                            (Tuple,
-                                for(auto& val : e.vals)
-                                    H::visit_param(*this, val);
-                                ),
-                            (Array,
-                                for(auto& val : e.vals)
-                                    H::visit_param(*this, val);
-                                ),
-                            (Variant,
-                                H::visit_param(*this, e.val);
-                                ),
-                            (Struct,
-                                for(auto& val : e.vals)
-                                    H::visit_param(*this, val);
-                                )
+                    TU_IFLET(::MIR::Statement, stmt, Assign, se,
+                        H::visit_lvalue(*this, se.dst);
+                        TU_MATCHA( (se.src), (e),
+                        (Use,
+                            H::visit_lvalue(*this, e);
+                            ),
+                        (Constant,
+                            H::visit_constant(*this, e);
+                            ),
+                        (SizedArray,
+                            H::visit_param(*this, e.val);
+                            ),
+                        (Borrow,
+                            H::visit_lvalue(*this, e.val);
+                            ),
+                        (Cast,
+                            H::visit_lvalue(*this, e.val);
+                            this->visit_type(e.type);
+                            ),
+                        (BinOp,
+                            H::visit_param(*this, e.val_l);
+                            H::visit_param(*this, e.val_r);
+                            ),
+                        (UniOp,
+                            H::visit_lvalue(*this, e.val);
+                            ),
+                        (DstMeta,
+                            H::visit_lvalue(*this, e.val);
+                            ),
+                        (DstPtr,
+                            H::visit_lvalue(*this, e.val);
+                            ),
+                        (MakeDst,
+                            H::visit_param(*this, e.ptr_val);
+                            H::visit_param(*this, e.meta_val);
+                            ),
+                        (Tuple,
+                            for(auto& val : e.vals)
+                                H::visit_param(*this, val);
+                            ),
+                        (Array,
+                            for(auto& val : e.vals)
+                                H::visit_param(*this, val);
+                            ),
+                        (Variant,
+                            H::visit_param(*this, e.val);
+                            ),
+                        (Struct,
+                            for(auto& val : e.vals)
+                                H::visit_param(*this, val);
                             )
                         )
-                        else TU_IFLET(::MIR::Statement, stmt, Drop, se,
-                            H::visit_lvalue(*this, se.slot);
-                        )
-                        else {
-                        }
+                    )
+                    else TU_IFLET(::MIR::Statement, stmt, Drop, se,
+                        H::visit_lvalue(*this, se.slot);
+                    )
+                    else {
                     }
-                    TU_MATCHA( (block.terminator), (te),
-                    (Incomplete, ),
-                    (Return, ),
-                    (Diverge, ),
-                    (Goto, ),
-                    (Panic, ),
-                    (If,
-                        H::visit_lvalue(*this, te.cond);
-                        ),
-                    (Switch,
-                        H::visit_lvalue(*this, te.val);
+                }
+                TU_MATCHA( (block.terminator), (te),
+                (Incomplete, ),
+                (Return, ),
+                (Diverge, ),
+                (Goto, ),
+                (Panic, ),
+                (If,
+                    H::visit_lvalue(*this, te.cond);
+                    ),
+                (Switch,
+                    H::visit_lvalue(*this, te.val);
+                    ),
+                (SwitchValue,
+                    H::visit_lvalue(*this, te.val);
+                    ),
+                (Call,
+                    H::visit_lvalue(*this, te.ret_val);
+                    TU_MATCHA( (te.fcn), (e2),
+                    (Value,
+                        H::visit_lvalue(*this, e2);
                         ),
-                    (SwitchValue,
-                        H::visit_lvalue(*this, te.val);
+                    (Path,
+                        visit_path(e2, ::HIR::Visitor::PathContext::VALUE);
                         ),
-                    (Call,
-                        H::visit_lvalue(*this, te.ret_val);
-                        TU_MATCHA( (te.fcn), (e2),
-                        (Value,
-                            H::visit_lvalue(*this, e2);
-                            ),
-                        (Path,
-                            visit_path(e2, ::HIR::Visitor::PathContext::VALUE);
-                            ),
-                        (Intrinsic,
-                            visit_path_params(e2.params);
-                            )
-                        )
-                        for(auto& arg : te.args)
-                            H::visit_param(*this, arg);
+                    (Intrinsic,
+                        visit_path_params(e2.params);
                         )
                     )
-                }
-            }
-            else
-            {
+                    for(auto& arg : te.args)
+                        H::visit_param(*this, arg);
+                    )
+                )
             }
         }
     };
@@ -863,3 +877,11 @@ void ConvertHIR_Bind(::HIR::Crate& crate)
 
     exp.visit_crate( crate );
 }
+void ConvertHIR_Bind_Mir(const ::HIR::Crate& crate, ::HIR::TypeRef& ret_ty, ::std::vector< ::HIR::TypeRef>& arg_tys, ::MIR::Function& mir)
+{
+    Visitor v { crate };
+    v.visit_type(ret_ty);
+    for(auto& ty : arg_tys)
+        v.visit_type(ty);
+    v.visit_ext_mir(mir);
+}
@@ -7,14 +7,22 @@
  */
 #pragma once
 
+#include <vector>
+
 namespace HIR {
     class Crate;
     class ItemPath;
     class ExprPtr;
+    class TypeRef;
+};
+namespace MIR {
+    class Function;
 };
 
 extern void ConvertHIR_ExpandAliases(::HIR::Crate& crate);
 extern void ConvertHIR_Bind(::HIR::Crate& crate);
+/// Bind a monomorphised function that was loaded from outside the crate (e.g. the MIR cache)
+extern void ConvertHIR_Bind_Mir(const ::HIR::Crate& crate, ::HIR::TypeRef& ret_ty, ::std::vector< ::HIR::TypeRef>& arg_tys, ::MIR::Function& mir);
 extern void ConvertHIR_ResolveUFCS_SortImpls(::HIR::Crate& crate);
 extern void ConvertHIR_ResolveUFCS_Outer(::HIR::Crate& crate);
 extern void ConvertHIR_ResolveUFCS(::HIR::Crate& crate);
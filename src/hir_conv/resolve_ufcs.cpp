@@ -15,6 +15,7 @@
 #include <hir/expr.hpp>
 #include <hir/visitor.hpp>
 #include <hir_typeck/static.hpp>
+#include <hir_typeck/impl_cache.hpp>
 #include <algorithm>    // std::remove_if
 
 namespace {
@@ -766,4 +767,6 @@ void ConvertHIR_ResolveUFCS_SortImpls(::HIR::Crate& crate)
     {
         sort_impl_group(impl_group.second);
     }
+    // Search order has changed, drop any cached impl searches
+    ImplQueryCache::clear_all();
 }
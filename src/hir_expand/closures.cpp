@@ -8,6 +8,7 @@
 #include <hir/visitor.hpp>
 #include <hir/expr.hpp>
 #include <hir_typeck/static.hpp>
+#include <hir_typeck/impl_cache.hpp>
 #include <algorithm>
 #include <hir/expr_state.hpp>
 #include "main_bindings.hpp"
@@ -48,6 +49,8 @@ namespace {
 
     void push_new_impls(const Span& sp, ::HIR::Crate& crate, out_impls_t new_trait_impls)
     {
+        // The set of impls is changing, so cached searches are stale
+        ImplQueryCache::clear_all();
         for(auto& impl : new_trait_impls)
         {
             ::HIR::Crate::ImplGroup<::HIR::TraitImpl>::list_t* trait_impl_list;
@@ -838,6 +841,7 @@ namespace {
 
             if( node.m_is_copy )
             {
+                ImplQueryCache::clear_all();
                 auto& v = const_cast<::HIR::Crate&>(m_resolve.m_crate).m_trait_impls[m_resolve.m_crate.get_lang_item_path(sp, "copy")].get_list_for_type_mut(closure_type);
                 v.push_back(box$(::HIR::TraitImpl {
                     params.clone(), {}, closure_type.clone(),
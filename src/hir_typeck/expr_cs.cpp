@@ -59,6 +59,35 @@ struct Context
         //unsigned int ivar;
     };
 
+    /// A `possible_equate_type*` call made while checking a rule
+    struct PossibleCall
+    {
+        enum class Kind {
+            Equate,
+            Bound,
+            Disable,
+            DisableStrong,
+        }   kind;
+        unsigned int    ivar_index;
+        bool    is_to;
+        bool    is_borrow;
+        Span    span;
+        ::HIR::TypeRef  ty;
+    };
+    /// Record of a rule check that had no effect other than adding ivar possibilities
+    ///
+    /// Checking the rule again can only give a different result once one of the ivars it looked up has changed (or
+    /// something outside of the ivar table has, see `HMTypeInferrence::mark_change`). Until then the check is skipped,
+    /// and the recorded possibilities (which are cleared every pass) are replayed instead.
+    struct RuleWait
+    {
+        /// `HMTypeInferrence::stamp` after the check, zero if the rule has to be checked
+        unsigned long   stamp = 0;
+        /// Root ivars looked up by the check
+        ::std::vector<unsigned int> ivars;
+        ::std::vector<PossibleCall> possibles;
+    };
+
     /// Inferrence variable equalities
     struct Coercion
     {
@@ -66,6 +95,8 @@ struct Context
         ::HIR::TypeRef  left_ty;
         ::HIR::ExprNodeP* right_node_ptr;
 
+        RuleWait    wait;
+
         friend ::std::ostream& operator<<(::std::ostream& os, const Coercion& v) {
             os << "R" << v.rule_idx << " " << v.left_ty << " := " << v.right_node_ptr << " " << &**v.right_node_ptr << " (" << (*v.right_node_ptr)->m_res_type << ")";
             return os;
@@ -85,6 +116,8 @@ struct Context
         // HACK: operators are special - the result when both types are primitives is ALWAYS the lefthand side
         bool    is_operator;
 
+        RuleWait    wait;
+
         friend ::std::ostream& operator<<(::std::ostream& os, const Associated& v) {
             os << "R" << v.rule_idx << " ";
             if( v.name == "" ) {
@@ -154,8 +187,9 @@ struct Context
 
     // Keep track of if an ivar is used in a context where it has to be Sized
     // - If it is, then we can discount any unsized possibilities
-    ::std::vector<bool> m_ivars_sized;
     ::std::vector< IVarPossible>    possible_ivar_vals;
+    /// If set, `possible_equate_type*` calls are recorded here (see `check_rule`)
+    ::std::vector<PossibleCall>*    m_possible_log = nullptr;
 
     const ::HIR::SimplePath m_lang_Box;
 
@@ -248,6 +282,11 @@ struct Context
     void possible_equate_type(unsigned int ivar_index, const ::HIR::TypeRef& t, bool is_to, bool is_borrow);
     void possible_equate_type_disable(unsigned int ivar_index, bool is_to);
     void possible_equate_type_disable_strong(const Span& sp, unsigned int ivar_index);
+    void replay_possible(const PossibleCall& call);
+
+    /// Run `check` for a rule, unless the rule is still waiting on its ivars (see `RuleWait`)
+    template<typename T>
+    bool check_rule(RuleWait& wait, T check);
 
     // - Add a pattern binding (forcing the type to match)
     void handle_pattern(const Span& sp, ::HIR::Pattern& pat, const ::HIR::TypeRef& type);
@@ -272,6 +311,66 @@ private:
     }
 };
 
+template<typename T>
+bool Context::check_rule(RuleWait& wait, T check)
+{
+    if( wait.stamp != 0 && m_ivars.external_stamp() <= wait.stamp )
+    {
+        bool changed = false;
+        for(auto idx : wait.ivars)
+        {
+            if( m_ivars.ivar_stamp(idx) > wait.stamp ) {
+                changed = true;
+                break;
+            }
+        }
+        if( !changed )
+        {
+            DEBUG("- Waiting on " << wait.ivars.size() << " ivars");
+            for(const auto& call : wait.possibles)
+                this->replay_possible(call);
+            return false;
+        }
+    }
+
+    // Record the ivars looked up and possibilities added by the check
+    struct Guard {
+        Context& context;
+        ~Guard() {
+            context.m_ivars.set_read_log(nullptr);
+            context.m_possible_log = nullptr;
+        }
+    };
+    ::std::vector<unsigned int> ivars;
+    ::std::vector<PossibleCall> possibles;
+    auto stamp = m_ivars.stamp();
+    auto n_visit = to_visit.size();
+    auto n_adv = adv_revisits.size();
+    bool rv;
+    {
+        Guard   guard { *this };
+        m_ivars.set_read_log(&ivars);
+        m_possible_log = &possibles;
+        rv = check();
+    }
+
+    if( !rv && m_ivars.stamp() == stamp && to_visit.size() == n_visit && adv_revisits.size() == n_adv )
+    {
+        ::std::sort(ivars.begin(), ivars.end());
+        ivars.erase( ::std::unique(ivars.begin(), ivars.end()), ivars.end() );
+        wait.stamp = stamp;
+        wait.ivars = mv$(ivars);
+        wait.possibles = mv$(possibles);
+    }
+    else
+    {
+        wait.stamp = 0;
+        wait.ivars.clear();
+        wait.possibles.clear();
+    }
+    return rv;
+}
+
 static void fix_param_count(const Span& sp, Context& context, const ::HIR::TypeRef& self_ty, bool use_defaults, const ::HIR::Path& path, const ::HIR::GenericParams& param_defs,  ::HIR::PathParams& params);
 static void fix_param_count(const Span& sp, Context& context, const ::HIR::TypeRef& self_ty, bool use_defaults, const ::HIR::GenericPath& path, const ::HIR::GenericParams& param_defs,  ::HIR::PathParams& params);
 
@@ -3690,21 +3789,12 @@ void Context::equate_types_inner(const Span& sp, const ::HIR::TypeRef& li, const
     TU_IFLET(::HIR::TypeRef::Data, r_t.m_data, Infer, r_e,
         TU_IFLET(::HIR::TypeRef::Data, l_t.m_data, Infer, l_e,
             // If both are infer, unify the two ivars (alias right to point to left)
-            // TODO: Unify sized flags
-
-            if( (r_e.index < m_ivars_sized.size() && m_ivars_sized.at(r_e.index))
-              ||(l_e.index < m_ivars_sized.size() && m_ivars_sized.at(l_e.index))
-                )
-            {
-                this->require_sized(sp, l_t);
-                this->require_sized(sp, r_t);
-            }
-
+            // - Sized flags are merged by the unify
             this->m_ivars.ivar_unify(l_e.index, r_e.index);
         )
         else {
             // Righthand side is infer, alias it to the left
-            if( r_e.index < m_ivars_sized.size() && m_ivars_sized.at(r_e.index) ) {
+            if( this->m_ivars.ivar_is_sized(r_e.index) ) {
                 this->require_sized(sp, l_t);
             }
             this->m_ivars.set_ivar_to(r_e.index, l_t.clone());
@@ -3713,7 +3803,7 @@ void Context::equate_types_inner(const Span& sp, const ::HIR::TypeRef& li, const
     else {
         TU_IFLET(::HIR::TypeRef::Data, l_t.m_data, Infer, l_e,
             // Lefthand side is infer, alias it to the right
-            if( l_e.index < m_ivars_sized.size() && m_ivars_sized.at(l_e.index) ) {
+            if( this->m_ivars.ivar_is_sized(l_e.index) ) {
                 this->require_sized(sp, r_t);
             }
             this->m_ivars.set_ivar_to(l_e.index, r_t.clone());
@@ -5319,7 +5409,8 @@ void Context::equate_types_assoc(const Span& sp, const ::HIR::TypeRef& l,  const
         is_op
         });
     DEBUG("++ " << this->link_assoc.back());
-    this->m_ivars.mark_change();
+    // NOTE: Rule checks don't look at other rules, so this doesn't need to wake them
+    this->m_ivars.mark_progress();
 }
 void Context::add_revisit(::HIR::ExprNode& node) {
     this->to_visit.push_back( &node );
@@ -5346,9 +5437,7 @@ void Context::require_sized(const Span& sp, const ::HIR::TypeRef& ty_)
         default:
             // TODO: Flag for future checking
             ASSERT_BUG(sp, e->index != ~0u, "Unbound ivar " << ty);
-            if(e->index >= m_ivars_sized.size())
-                m_ivars_sized.resize(e->index+1);
-            m_ivars_sized.at(e->index) = true;
+            m_ivars.set_ivar_sized(e->index);
             break;
         }
     }
@@ -5414,6 +5503,9 @@ void Context::require_sized(const Span& sp, const ::HIR::TypeRef& ty_)
 
 void Context::possible_equate_type(unsigned int ivar_index, const ::HIR::TypeRef& t, bool is_to, bool is_borrow) {
     DEBUG(ivar_index << " " << (is_borrow ? "unsize":"coerce") << " " << (is_to?"to":"from") << " " << t << " " << this->m_ivars.get_type(t));
+    if( m_possible_log ) {
+        m_possible_log->push_back(PossibleCall { PossibleCall::Kind::Equate, ivar_index, is_to, is_borrow, Span(), t.clone() });
+    }
     {
         ::HIR::TypeRef  ty_l;
         ty_l.m_data.as_Infer().index = ivar_index;
@@ -5436,6 +5528,9 @@ void Context::possible_equate_type(unsigned int ivar_index, const ::HIR::TypeRef
     list.push_back( t.clone() );
 }
 void Context::possible_equate_type_bound(const Span& sp, unsigned int ivar_index, const ::HIR::TypeRef& t) {
+    if( m_possible_log ) {
+        m_possible_log->push_back(PossibleCall { PossibleCall::Kind::Bound, ivar_index, false, false, sp, t.clone() });
+    }
     {
         ::HIR::TypeRef  ty_l;
         ty_l.m_data.as_Infer().index = ivar_index;
@@ -5472,6 +5567,9 @@ void Context::possible_equate_type_bound(const Span& sp, unsigned int ivar_index
 }
 void Context::possible_equate_type_disable(unsigned int ivar_index, bool is_to) {
     DEBUG(ivar_index << " ?= ?? (" << (is_to ? "to" : "from") << ")");
+    if( m_possible_log ) {
+        m_possible_log->push_back(PossibleCall { PossibleCall::Kind::Disable, ivar_index, is_to, false, Span(), ::HIR::TypeRef() });
+    }
     {
         ::HIR::TypeRef  ty_l;
         ty_l.m_data.as_Infer().index = ivar_index;
@@ -5492,6 +5590,9 @@ void Context::possible_equate_type_disable(unsigned int ivar_index, bool is_to)
 void Context::possible_equate_type_disable_strong(const Span& sp, unsigned int ivar_index)
 {
     DEBUG(ivar_index << " = ??");
+    if( m_possible_log ) {
+        m_possible_log->push_back(PossibleCall { PossibleCall::Kind::DisableStrong, ivar_index, false, false, sp, ::HIR::TypeRef() });
+    }
     {
         ::HIR::TypeRef  ty_l;
         ty_l.m_data.as_Infer().index = ivar_index;
@@ -5504,6 +5605,24 @@ void Context::possible_equate_type_disable_strong(const Span& sp, unsigned int i
     auto& ent = possible_ivar_vals[ivar_index];
     ent.force_disable = true;
 }
+void Context::replay_possible(const PossibleCall& call)
+{
+    switch(call.kind)
+    {
+    case PossibleCall::Kind::Equate:
+        this->possible_equate_type(call.ivar_index, call.ty, call.is_to, call.is_borrow);
+        break;
+    case PossibleCall::Kind::Bound:
+        this->possible_equate_type_bound(call.span, call.ivar_index, call.ty);
+        break;
+    case PossibleCall::Kind::Disable:
+        this->possible_equate_type_disable(call.ivar_index, call.is_to);
+        break;
+    case PossibleCall::Kind::DisableStrong:
+        this->possible_equate_type_disable_strong(call.span, call.ivar_index);
+        break;
+    }
+}
 
 void Context::add_var(const Span& sp, unsigned int index, const RcString& name, ::HIR::TypeRef type) {
     DEBUG("(" << index << " " << name << " : " << type << ")");
@@ -5692,7 +5811,7 @@ namespace {
         // Can't Unsize to a known-Sized type.
         // BUT! Can do a Deref coercion to a Sized type.
         #if 0
-        if( dst.m_data.is_Infer() && dst.m_data.as_Infer().index < context.m_ivars_sized.size() && context.m_ivars_sized.at( dst.m_data.as_Infer().index ) )
+        if( dst.m_data.is_Infer() && context.m_ivars.ivar_is_sized( dst.m_data.as_Infer().index ) )
         {
             DEBUG("Can't unsize to known-Sized type");
             return CoerceResult::Equality;
@@ -7171,7 +7290,7 @@ namespace {
                 static bool is_dest_s(const PossibleType& self) { return self.is_dest(); }
             };
 
-            bool allow_unsized = !(i < context.m_ivars_sized.size() ? context.m_ivars_sized.at(i) : false);
+            bool allow_unsized = !context.m_ivars.ivar_is_sized(i);
 
             ::std::vector<PossibleType> possible_tys;
             static ::HIR::TypeRef   null_placeholder;
@@ -8382,6 +8501,28 @@ namespace {
 
         return false;
     }
+
+    /// Revisit all nodes in `to_visit`, removing those that are completed
+    void revisit_nodes(Context& context, bool is_fallback)
+    {
+        // - Completed nodes are removed by compacting the list as it's walked (keeping the order)
+        size_t  n_keep = 0;
+        for(size_t i = 0; i < context.to_visit.size(); i ++)
+        {
+            ::HIR::ExprNode& node = *context.to_visit[i];
+            ExprVisitor_Revisit visitor { context, is_fallback };
+            DEBUG("> " << &node << " " << typeid(node).name() << " -> " << context.m_ivars.fmt_type(node.m_res_type));
+            node.visit( visitor );
+            //  - If the node is completed, remove it
+            if( visitor.node_completed() ) {
+                DEBUG("- Completed " << &node << " - " << typeid(node).name());
+            }
+            else {
+                context.to_visit[n_keep++] = &node;
+            }
+        }
+        context.to_visit.resize(n_keep);
+    }
 }
 
 
@@ -8453,36 +8594,28 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
         // 2. (???) Locate coercions that cannot coerce (due to being the only way to know a type)
         // - Keep a list in the ivar of what types that ivar could be equated to.
         DEBUG("--- Coercion checking");
-        for(size_t i = 0; i < context.link_coerce.size(); )
+        // - Consumed entries are removed by compacting the list as it's walked (keeping the order)
+        size_t  n_coerce = 0;
+        for(size_t i = 0; i < context.link_coerce.size(); i ++)
         {
             auto ent = mv$(context.link_coerce[i]);
             const auto& span = (*ent->right_node_ptr)->span();
             auto& src_ty = (*ent->right_node_ptr)->m_res_type;
-            //src_ty = context.m_resolve.expand_associated_types( span, mv$(src_ty) );
-            ent->left_ty = context.m_resolve.expand_associated_types( span, mv$(ent->left_ty) );
-            if( check_coerce(context, *ent) )
+            bool consumed = context.check_rule(ent->wait, [&]() {
+                //src_ty = context.m_resolve.expand_associated_types( span, mv$(src_ty) );
+                ent->left_ty = context.m_resolve.expand_associated_types( span, mv$(ent->left_ty) );
+                return check_coerce(context, *ent);
+                });
+            if( consumed )
             {
                 DEBUG("- Consumed coercion " << ent->left_ty << " := " << src_ty);
-
-#if 0
-                // If this isn't the last item in the list
-                if( i != context.link_coerce.size() - 1 )
-                {
-                    // Swap with the last item
-                    context.link_coerce[i] = mv$(context.link_coerce.back());
-                }
-                // Remove the last item.
-                context.link_coerce.pop_back();
-#else
-                context.link_coerce.erase( context.link_coerce.begin() + i );
-#endif
             }
             else
             {
-                context.link_coerce[i] = mv$(ent);
-                ++ i;
+                context.link_coerce[n_coerce++] = mv$(ent);
             }
         }
+        context.link_coerce.resize(n_coerce);
         // 3. Check associated type rules
         DEBUG("--- Associated types");
         unsigned int link_assoc_iter_limit = context.link_assoc.size() * 4;
@@ -8491,19 +8624,22 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
             auto rule = mv$(context.link_assoc[i]);
 
             DEBUG("- " << rule);
-            for( auto& ty : rule.params.m_types ) {
-                ty = context.m_resolve.expand_associated_types(rule.span, mv$(ty));
-            }
-            if( rule.name != "" ) {
-                rule.left_ty = context.m_resolve.expand_associated_types(rule.span, mv$(rule.left_ty));
-                // HACK: If the left type is `!`, remove the type bound
-                //if( rule.left_ty.m_data.is_Diverge() ) {
-                //    rule.name = "";
-                //}
-            }
-            rule.impl_ty = context.m_resolve.expand_associated_types(rule.span, mv$(rule.impl_ty));
+            bool consumed = context.check_rule(rule.wait, [&]() {
+                for( auto& ty : rule.params.m_types ) {
+                    ty = context.m_resolve.expand_associated_types(rule.span, mv$(ty));
+                }
+                if( rule.name != "" ) {
+                    rule.left_ty = context.m_resolve.expand_associated_types(rule.span, mv$(rule.left_ty));
+                    // HACK: If the left type is `!`, remove the type bound
+                    //if( rule.left_ty.m_data.is_Diverge() ) {
+                    //    rule.name = "";
+                    //}
+                }
+                rule.impl_ty = context.m_resolve.expand_associated_types(rule.span, mv$(rule.impl_ty));
 
-            if( check_associated(context, rule) ) {
+                return check_associated(context, rule);
+                });
+            if( consumed ) {
                 DEBUG("- Consumed associated type rule " << i << "/" << context.link_assoc.size() << " - " << rule);
                 if( i != context.link_assoc.size()-1 )
                 {
@@ -8525,35 +8661,22 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
         }
         // 4. Revisit nodes that require revisiting
         DEBUG("--- Node revisits");
-        for( auto it = context.to_visit.begin(); it != context.to_visit.end(); )
-        {
-            ::HIR::ExprNode& node = **it;
-            ExprVisitor_Revisit visitor { context };
-            DEBUG("> " << &node << " " << typeid(node).name() << " -> " << context.m_ivars.fmt_type(node.m_res_type));
-            node.visit( visitor );
-            //  - If the node is completed, remove it
-            if( visitor.node_completed() ) {
-                DEBUG("- Completed " << &node << " - " << typeid(node).name());
-                it = context.to_visit.erase(it);
-            }
-            else {
-                ++ it;
-            }
-        }
+        revisit_nodes(context, /*is_fallback=*/false);
         {
-            ::std::vector<bool> adv_revisit_remove_list;
+            // - Entries added during the loop are kept (and not visited until the next pass)
             size_t  len = context.adv_revisits.size();
+            size_t  n_keep = 0;
             for(size_t i = 0; i < len; i ++)
             {
                 auto& ent = *context.adv_revisits[i];
-                adv_revisit_remove_list.push_back( ent.revisit(context, /*is_fallback=*/false) );
-            }
-            for(size_t i = len; i --;)
-            {
-                if( adv_revisit_remove_list[i] ) {
-                    context.adv_revisits.erase( context.adv_revisits.begin() + i );
+                if( !ent.revisit(context, /*is_fallback=*/false) )
+                {
+                    if( n_keep != i )
+                        context.adv_revisits[n_keep] = mv$(context.adv_revisits[i]);
+                    n_keep ++;
                 }
             }
+            context.adv_revisits.erase( context.adv_revisits.begin() + n_keep, context.adv_revisits.begin() + len );
         }
 
         // If nothing changed this pass, apply ivar possibilities
@@ -8713,21 +8836,7 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
         if( !context.m_ivars.peek_changed() )
         {
             DEBUG("--- Node revisits (fallback)");
-            for( auto it = context.to_visit.begin(); it != context.to_visit.end(); )
-            {
-                ::HIR::ExprNode& node = **it;
-                ExprVisitor_Revisit visitor { context, true };
-                DEBUG("> " << &node << " " << typeid(node).name() << " -> " << context.m_ivars.fmt_type(node.m_res_type));
-                node.visit( visitor );
-                //  - If the node is completed, remove it
-                if( visitor.node_completed() ) {
-                    DEBUG("- Completed " << &node << " - " << typeid(node).name());
-                    it = context.to_visit.erase(it);
-                }
-                else {
-                    ++ it;
-                }
-            }
+            revisit_nodes(context, /*is_fallback=*/true);
             #if 0
             for( auto it = context.adv_revisits.begin(); it != context.adv_revisits.end(); )
             {
@@ -10,6 +10,10 @@
 #include <hir/visitor.hpp>
 #include "expr_visit.hpp"
 #include <hir/expr_state.hpp>
+#include <thread_pool.hpp>
+#include <atomic>
+#include <iostream>
+#include <unordered_set>
 
 void Typecheck_Code(const typeck::ModuleState& ms, t_args& args, const ::HIR::TypeRef& result_type, ::HIR::ExprPtr& expr) {
     if( expr.m_state->stage < ::HIR::ExprState::Stage::Typecheck )
@@ -105,17 +109,67 @@ namespace typeck {
 
 namespace {
 
+    /// A body collected for parallel typechecking, with a copy of the module state it's checked in
+    struct Job
+    {
+        ::typeck::ModuleState   ms;
+        // Function arguments (nullptr for bodies without arguments, which use `no_args`)
+        t_args* args;
+        t_args  no_args;
+        ::HIR::TypeRef  result_type;
+        ::HIR::ExprPtr* expr;
+
+        // Span messages emitted while checking, and if one of them was fatal
+        ::std::string   messages;
+        bool    failed = false;
+
+        Job(const ::typeck::ModuleState& ms, t_args* args, const ::HIR::TypeRef& result_type, ::HIR::ExprPtr& expr):
+            ms(ms),
+            args(args),
+            result_type(result_type.clone()),
+            expr(&expr)
+        {
+        }
+        Job(const Job&) = delete;
+    };
 
     class OuterVisitor:
         public ::HIR::Visitor
     {
         ::typeck::ModuleState m_ms;
     public:
+        /// When set, bodies are collected here (to be checked in parallel) instead of being checked immediately
+        ::std::vector< ::std::unique_ptr<Job> >*    m_jobs = nullptr;
+        /// Bodies already in `m_jobs` (array sizes can be shared between types)
+        ::std::unordered_set<const ::HIR::ExprPtr*> m_job_exprs;
+
         OuterVisitor(::HIR::Crate& crate):
             m_ms(crate)
         {
         }
 
+    private:
+        /// Typecheck a body (or queue it, if collecting jobs), `args` is nullptr for bodies without arguments
+        void handle_body(t_args* args, const ::HIR::TypeRef& result_type, ::HIR::ExprPtr& expr)
+        {
+            if( m_jobs )
+            {
+                if( m_job_exprs.insert(&expr).second )
+                {
+                    m_jobs->push_back(::std::unique_ptr<Job>(new Job(m_ms, args, result_type, expr)));
+                }
+            }
+            else if( args )
+            {
+                Typecheck_Code(m_ms, *args, result_type, expr);
+            }
+            else
+            {
+                t_args  tmp;
+                Typecheck_Code(m_ms, tmp, result_type, expr);
+            }
+        }
+
 
     public:
         void visit_module(::HIR::ItemPath p, ::HIR::Module& mod) override
@@ -174,9 +228,8 @@ namespace {
             TU_IFLET(::HIR::TypeRef::Data, ty.m_data, Array, e,
                 this->visit_type( *e.inner );
                 DEBUG("Array size " << ty);
-                t_args  tmp;
                 if( e.size ) {
-                    Typecheck_Code( m_ms, tmp, ::HIR::TypeRef(::HIR::CoreType::Usize), *e.size );
+                    this->handle_body( nullptr, ::HIR::TypeRef(::HIR::CoreType::Usize), *e.size );
                 }
             )
             else {
@@ -191,7 +244,7 @@ namespace {
             if( item.m_code )
             {
                 DEBUG("Function code " << p);
-                Typecheck_Code( m_ms, item.m_args, item.m_return, item.m_code );
+                this->handle_body( &item.m_args, item.m_return, item.m_code );
             }
             else
             {
@@ -203,8 +256,7 @@ namespace {
             if( item.m_value )
             {
                 DEBUG("Static value " << p);
-                t_args  tmp;
-                Typecheck_Code(m_ms, tmp, item.m_type, item.m_value);
+                this->handle_body(nullptr, item.m_type, item.m_value);
             }
         }
         void visit_constant(::HIR::ItemPath p, ::HIR::Constant& item) override {
@@ -212,8 +264,7 @@ namespace {
             if( item.m_value )
             {
                 DEBUG("Const value " << p);
-                t_args  tmp;
-                Typecheck_Code(m_ms, tmp, item.m_type, item.m_value);
+                this->handle_body(nullptr, item.m_type, item.m_value);
             }
         }
         void visit_enum(::HIR::ItemPath p, ::HIR::Enum& item) override {
@@ -228,8 +279,7 @@ namespace {
                     DEBUG("Enum value " << p << " - " << var.name);
                     if( var.expr )
                     {
-                        t_args  tmp;
-                        Typecheck_Code(m_ms, tmp, enum_type, var.expr);
+                        this->handle_body(nullptr, enum_type, var.expr);
                     }
                 }
             }
@@ -240,5 +290,47 @@ namespace {
 void Typecheck_Expressions(::HIR::Crate& crate)
 {
     OuterVisitor    visitor { crate };
+    if( g_num_threads <= 1 )
+    {
+        visitor.visit_crate( crate );
+        return ;
+    }
+
+    // Collect all bodies, then check them in parallel
+    // - Each body has its own inferrence context, and the crate is only read (except for caches, which are locked)
+    ::std::vector< ::std::unique_ptr<Job> > jobs;
+    visitor.m_jobs = &jobs;
     visitor.visit_crate( crate );
+    visitor.m_jobs = nullptr;
+
+    // Bodies after a failed one are skipped, as their messages wouldn't be printed
+    ::std::atomic<size_t>   first_failure { jobs.size() };
+    ThreadPool  pool;
+    pool.for_each_index(jobs.size(), [&](size_t i) {
+        if( i > first_failure.load() )
+            return ;
+        auto& job = *jobs[i];
+        SpanMessageCapture  capture { job.messages };
+        try
+        {
+            Typecheck_Code(job.ms, job.args ? *job.args : job.no_args, job.result_type, *job.expr);
+        }
+        catch(const SpanMessageCapture::Fatal& )
+        {
+            job.failed = true;
+            size_t  prev = first_failure.load();
+            while( i < prev && !first_failure.compare_exchange_weak(prev, i) )
+                ;
+        }
+        });
+
+    // Print messages in item order (as a serial run would), stopping at the first error
+    for(const auto& job : jobs)
+    {
+        ::std::cerr << job->messages;
+        if( job->failed )
+        {
+            SpanMessageCapture::exit_fatal();
+        }
+    }
 }
@@ -6,35 +6,38 @@
  * - Typecheck helpers
  */
 #include "helpers.hpp"
+#include "impl_cache.hpp"
+#include <algorithm>    // std::min
+#include <cstdint>  // SIZE_MAX
+#include <mutex>
 
 // --------------------------------------------------------------------
 // HMTypeInferrence
 // --------------------------------------------------------------------
 void HMTypeInferrence::dump() const
 {
-    unsigned int i = 0;
-    for(const auto& v : m_ivars) {
-        if(v.is_alias()) {
-            //DEBUG("#" << i << " = " << v.alias);
-        }
-        else {
-            DEBUG("#" << i << " = " << *v.type << FMT_CB(os,
-                bool open = false;
-                unsigned int i2 = 0;
-                for(const auto& v2 : m_ivars) {
-                    if( v2.is_alias() && v2.alias == i ) {
-                        if( !open )
-                            os << " { ";
-                        open = true;
-                        os << "#" << i2 << " ";
-                    }
-                    i2 ++;
-                }
-                if(open)
-                    os << "}";
-                ));
-        }
-        i ++ ;
+    if( !DEBUG_ENABLED )
+        return ;
+    // Group the aliased ivars by their root
+    ::std::vector< ::std::vector<unsigned int> >  aliases( m_ivar_parent.size() );
+    for(unsigned int i = 0; i < m_ivar_parent.size(); i ++)
+    {
+        auto root = this->get_root(i);
+        if( root != i )
+            aliases[root].push_back(i);
+    }
+    for(unsigned int i = 0; i < m_ivar_parent.size(); i ++)
+    {
+        if( !this->ivar_is_root(i) )
+            continue ;
+        DEBUG("#" << i << " = " << m_ivar_types[i] << FMT_CB(os,
+            if( !aliases[i].empty() ) {
+                os << " { ";
+                for(auto i2 : aliases[i])
+                    os << "#" << i2 << " ";
+                os << "}";
+            }
+            ));
     }
 }
 void HMTypeInferrence::check_for_loops()
@@ -69,13 +72,12 @@ void HMTypeInferrence::check_for_loops()
             TU_MATCH( ::HIR::TypeRef::Data, (ty.m_data), (e),
             (Infer,
                 for(auto idx : m_indexes)
-                    ASSERT_BUG(Span(), e.index != idx, "Recursion in ivar #" << m_indexes.front() << " " << *ivars.m_ivars[m_indexes.front()].type
-                        << " - loop with " << idx << " " << *ivars.m_ivars[idx].type);
-                const auto& ivd = ivars.get_pointed_ivar(e.index);
-                assert( !ivd.is_alias() );
-                if( !ivd.type->m_data.is_Infer() ) {
+                    ASSERT_BUG(Span(), e.index != idx, "Recursion in ivar #" << m_indexes.front() << " " << ivars.m_ivar_types[m_indexes.front()]
+                        << " - loop with " << idx << " " << ivars.m_ivar_types[idx]);
+                const auto& ivd = ivars.m_ivar_types[ivars.get_root(e.index)];
+                if( !ivd.m_data.is_Infer() ) {
                     m_indexes.push_back( e.index );
-                    this->check_ty(ivars, *ivd.type);
+                    this->check_ty(ivars, ivd);
                     m_indexes.pop_back( );
                 }
                 ),
@@ -130,58 +132,34 @@ void HMTypeInferrence::check_for_loops()
             )
         }
     };
-    unsigned int i = 0;
-    for(const auto& v : m_ivars)
+    for(unsigned int i = 0; i < m_ivar_parent.size(); i ++)
     {
-        if( !v.is_alias() && !v.type->m_data.is_Infer() )
+        if( this->ivar_is_root(i) && !m_ivar_types[i].m_data.is_Infer() )
         {
-            DEBUG("- " << i << " " << *v.type);
-            (LoopChecker { {i} }).check_ty(*this, *v.type);
+            DEBUG("- " << i << " " << m_ivar_types[i]);
+            (LoopChecker { {i} }).check_ty(*this, m_ivar_types[i]);
         }
-        i ++;
     }
 }
 void HMTypeInferrence::compact_ivars()
 {
     this->check_for_loops();
 
-    unsigned int i = 0;
-    for(auto& v : m_ivars)
+    // Point every ivar directly at its root
+    for(unsigned int i = 0; i < m_ivar_parent.size(); i ++)
     {
-        if( !v.is_alias() ) {
-            //auto nt = this->expand_associated_types(Span(), v.type->clone());
-            auto nt = v.type->clone();
-
-            DEBUG("- " << i << " " << *v.type << " -> " << nt);
-            *v.type = mv$(nt);
-        }
-        else {
-
-            auto index = v.alias;
-            unsigned int count = 0;
-            assert(index < m_ivars.size());
-            while( m_ivars.at(index).is_alias() ) {
-                index = m_ivars.at(index).alias;
-
-                if( count >= m_ivars.size() ) {
-                    this->dump();
-                    BUG(Span(), "Loop detected in ivar list when starting at " << v.alias << ", current is " << index);
-                }
-                count ++;
-            }
-            v.alias = index;
-        }
-        i ++;
+        this->get_root(i);
     }
 }
 
 bool HMTypeInferrence::apply_defaults()
 {
     bool rv = false;
-    for(auto& v : m_ivars)
+    for(unsigned int i = 0; i < m_ivar_parent.size(); i ++)
     {
-        if( !v.is_alias() ) {
-            TU_IFLET(::HIR::TypeRef::Data, v.type->m_data, Infer, e,
+        if( this->ivar_is_root(i) ) {
+            auto& ty = m_ivar_types[i];
+            TU_IFLET(::HIR::TypeRef::Data, ty.m_data, Infer, e,
                 switch(e.ty_class)
                 {
                 case ::HIR::InferClass::None:
@@ -189,17 +167,17 @@ bool HMTypeInferrence::apply_defaults()
                 case ::HIR::InferClass::Diverge:
                     rv = true;
                     DEBUG("- IVar " << e.index << " = !");
-                    *v.type = ::HIR::TypeRef(::HIR::TypeRef::Data::make_Diverge({}));
+                    ty = ::HIR::TypeRef(::HIR::TypeRef::Data::make_Diverge({}));
                     break;
                 case ::HIR::InferClass::Integer:
                     rv = true;
                     DEBUG("- IVar " << e.index << " = i32");
-                    *v.type = ::HIR::TypeRef( ::HIR::CoreType::I32 );
+                    ty = ::HIR::TypeRef( ::HIR::CoreType::I32 );
                     break;
                 case ::HIR::InferClass::Float:
                     rv = true;
                     DEBUG("- IVar " << e.index << " = f64");
-                    *v.type = ::HIR::TypeRef( ::HIR::CoreType::F64 );
+                    ty = ::HIR::TypeRef( ::HIR::CoreType::F64 );
                     break;
                 }
             )
@@ -440,7 +418,7 @@ void HMTypeInferrence::add_ivars(::HIR::TypeRef& type)
         if( e.index == ~0u ) {
             e.index = this->new_ivar();
             this->get_type(type).m_data.as_Infer().ty_class = e.ty_class;
-            this->mark_change();
+            this->mark_progress();
             DEBUG("New ivar " << type);
         }
         ),
@@ -518,9 +496,13 @@ void HMTypeInferrence::add_ivars_params(::HIR::PathParams& params)
 
 unsigned int HMTypeInferrence::new_ivar()
 {
-    m_ivars.push_back( IVar() );
-    m_ivars.back().type->m_data.as_Infer().index = m_ivars.size() - 1;
-    return m_ivars.size() - 1;
+    unsigned int idx = m_ivar_parent.size();
+    m_ivar_parent.push_back(idx);
+    m_ivar_stamp.push_back(++ m_stamp);
+    m_ivar_sized.push_back(false);
+    m_ivar_types.push_back( ::HIR::TypeRef() );
+    m_ivar_types.back().m_data.as_Infer().index = idx;
+    return idx;
 }
 ::HIR::TypeRef HMTypeInferrence::new_ivar_tr()
 {
@@ -533,7 +515,7 @@ unsigned int HMTypeInferrence::new_ivar()
 {
     TU_IFLET(::HIR::TypeRef::Data, type.m_data, Infer, e,
         assert(e.index != ~0u);
-        return *get_pointed_ivar(e.index).type;
+        return m_ivar_types[get_pointed_ivar(e.index)];
     )
     else {
         return type;
@@ -544,7 +526,7 @@ const ::HIR::TypeRef& HMTypeInferrence::get_type(const ::HIR::TypeRef& type) con
 {
     TU_IFLET(::HIR::TypeRef::Data, type.m_data, Infer, e,
         assert(e.index != ~0u);
-        return *get_pointed_ivar(e.index).type;
+        return m_ivar_types[get_pointed_ivar(e.index)];
     )
     else {
         return type;
@@ -554,17 +536,18 @@ const ::HIR::TypeRef& HMTypeInferrence::get_type(const ::HIR::TypeRef& type) con
 void HMTypeInferrence::set_ivar_to(unsigned int slot, ::HIR::TypeRef type)
 {
     auto sp = Span();
-    auto& root_ivar = this->get_pointed_ivar(slot);
-    DEBUG("set_ivar_to(" << slot << " { " << *root_ivar.type << " }, " << type << ")");
+    auto root = this->get_pointed_ivar(slot);
+    auto& root_type = m_ivar_types[root];
+    DEBUG("set_ivar_to(" << slot << " { " << root_type << " }, " << type << ")");
 
     // If the left type was '_', alias the right to it
-    if( const auto* l_e = type.m_data.opt_Infer() ) 
+    if( const auto* l_e = type.m_data.opt_Infer() )
     {
         assert( l_e->index != slot );
         if( l_e->ty_class != ::HIR::InferClass::None ) {
-            TU_MATCH_DEF(::HIR::TypeRef::Data, (root_ivar.type->m_data), (e),
+            TU_MATCH_DEF(::HIR::TypeRef::Data, (root_type.m_data), (e),
             (
-                ERROR(sp, E0000, "Type unificiation of literal with invalid type - " << *root_ivar.type);
+                ERROR(sp, E0000, "Type unificiation of literal with invalid type - " << root_type);
                 ),
             (Primitive,
                 check_type_class_primitive(sp, type, l_e->ty_class, e);
@@ -572,31 +555,27 @@ void HMTypeInferrence::set_ivar_to(unsigned int slot, ::HIR::TypeRef type)
             (Infer,
                 // Check for right having a ty_class
                 if( e.ty_class != ::HIR::InferClass::None && e.ty_class != l_e->ty_class ) {
-                    ERROR(sp, E0000, "Unifying types with mismatching literal classes - " << type << " := " << *root_ivar.type);
+                    ERROR(sp, E0000, "Unifying types with mismatching literal classes - " << type << " := " << root_type);
                 }
                 )
             )
         }
 
-        #if 1
         // Alias `l_e.index` to this slot
         DEBUG("Set IVar " << l_e->index << " = @" << slot);
-        auto& r_ivar = this->get_pointed_ivar(l_e->index);
-        r_ivar.alias = slot;
-        r_ivar.type.reset();
-        #else
-        DEBUG("Set IVar " << slot << " = @" << l_e->index);
-        root_ivar.alias = l_e->index;
-        root_ivar.type.reset();
-        #endif
+        auto r_root = this->get_pointed_ivar(l_e->index);
+        if( r_root == root )
+            return ;
+        this->link_ivars(root, r_root);
+        m_ivar_stamp[r_root] = m_stamp + 1; // Stamped with the `mark_progress` below
     }
-    else if( *root_ivar.type == type ) {
+    else if( root_type == type ) {
         return ;
     }
     else {
         // Otherwise, store left in right's slot
         DEBUG("Set IVar " << slot << " = " << type);
-        TU_IFLET(::HIR::TypeRef::Data, root_ivar.type->m_data, Infer, e,
+        TU_IFLET(::HIR::TypeRef::Data, root_type.m_data, Infer, e,
             switch(e.ty_class)
             {
             case ::HIR::InferClass::None:
@@ -618,28 +597,29 @@ void HMTypeInferrence::set_ivar_to(unsigned int slot, ::HIR::TypeRef type)
             }
         )
         #if 0
-        else TU_IFLET(::HIR::TypeRef::Data, root_ivar.type->m_data, Diverge, e,
+        else TU_IFLET(::HIR::TypeRef::Data, root_type.m_data, Diverge, e,
             // Overwriting ! with anything is valid (it's like a magic ivar)
         )
         #endif
         else {
-            BUG(sp, "Overwriting ivar " << slot << " (" << *root_ivar.type << ") with " << type);
+            BUG(sp, "Overwriting ivar " << slot << " (" << root_type << ") with " << type);
         }
 
         #if 1
         if( type.m_data.is_Diverge() )
         {
-            if( root_ivar.type->m_data.as_Infer().ty_class == ::HIR::InferClass::None )
+            if( root_type.m_data.as_Infer().ty_class == ::HIR::InferClass::None )
             {
-                root_ivar.type->m_data.as_Infer().ty_class = ::HIR::InferClass::Diverge;
+                root_type.m_data.as_Infer().ty_class = ::HIR::InferClass::Diverge;
             }
         }
         else
         #endif
-        root_ivar.type = box$( type );
+        root_type = mv$(type);
     }
 
-    this->mark_change();
+    this->mark_progress();
+    m_ivar_stamp[root] = m_stamp;
 }
 
 void HMTypeInferrence::ivar_unify(unsigned int left_slot, unsigned int right_slot)
@@ -647,17 +627,20 @@ void HMTypeInferrence::ivar_unify(unsigned int left_slot, unsigned int right_slo
     auto sp = Span();
     if( left_slot != right_slot )
     {
-        auto& left_ivar = this->get_pointed_ivar(left_slot);
+        auto left_root = this->get_pointed_ivar(left_slot);
+        auto& left_type = m_ivar_types[left_root];
 
-        // TODO: Assert that setting this won't cause a loop.
-        auto& root_ivar = this->get_pointed_ivar(right_slot);
+        auto right_root = this->get_pointed_ivar(right_slot);
+        const auto& right_type = m_ivar_types[right_root];
+        if( left_root == right_root )
+            return ;
 
-        if( const auto* re = root_ivar.type->m_data.opt_Infer() )
+        if( const auto* re = right_type.m_data.opt_Infer() )
         {
-            DEBUG("Class unify " << *left_ivar.type << " <- " << *root_ivar.type);
+            DEBUG("Class unify " << left_type << " <- " << right_type);
             if( re->ty_class == ::HIR::InferClass::Diverge )
             {
-                TU_IFLET(::HIR::TypeRef::Data, left_ivar.type->m_data, Infer, le,
+                TU_IFLET(::HIR::TypeRef::Data, left_type.m_data, Infer, le,
                     if( le.ty_class == ::HIR::InferClass::None ) {
                         le.ty_class = ::HIR::InferClass::Diverge;
                     }
@@ -665,9 +648,9 @@ void HMTypeInferrence::ivar_unify(unsigned int left_slot, unsigned int right_slo
             }
             else if(re->ty_class != ::HIR::InferClass::None)
             {
-                TU_MATCH_DEF(::HIR::TypeRef::Data, (left_ivar.type->m_data), (le),
+                TU_MATCH_DEF(::HIR::TypeRef::Data, (left_type.m_data), (le),
                 (
-                    ERROR(sp, E0000, "Type unificiation of literal with invalid type - " << *left_ivar.type);
+                    ERROR(sp, E0000, "Type unificiation of literal with invalid type - " << left_type);
                     ),
                 (Infer,
                     if( le.ty_class == ::HIR::InferClass::Diverge )
@@ -675,7 +658,7 @@ void HMTypeInferrence::ivar_unify(unsigned int left_slot, unsigned int right_slo
                     }
                     else if( le.ty_class != ::HIR::InferClass::None && le.ty_class != re->ty_class )
                     {
-                        ERROR(sp, E0000, "Unifying types with mismatching literal classes - " << *left_ivar.type << " := " << *root_ivar.type);
+                        ERROR(sp, E0000, "Unifying types with mismatching literal classes - " << left_type << " := " << right_type);
                     }
                     else
                     {
@@ -683,7 +666,7 @@ void HMTypeInferrence::ivar_unify(unsigned int left_slot, unsigned int right_slo
                     le.ty_class = re->ty_class;
                     ),
                 (Primitive,
-                    check_type_class_primitive(sp, *left_ivar.type, re->ty_class, le);
+                    check_type_class_primitive(sp, left_type, re->ty_class, le);
                     )
                 )
             }
@@ -692,31 +675,64 @@ void HMTypeInferrence::ivar_unify(unsigned int left_slot, unsigned int right_slo
             }
         }
         else {
-            BUG(sp, "Unifying over a concrete type - " << *root_ivar.type);
+            BUG(sp, "Unifying over a concrete type - " << right_type);
         }
 
-        DEBUG("IVar " << root_ivar.type->m_data.as_Infer().index << " = @" << left_slot);
-        root_ivar.alias = left_slot;
-        root_ivar.type.reset();
+        DEBUG("IVar " << right_root << " = @" << left_slot);
+        this->link_ivars(left_root, right_root);
 
-        this->mark_change();
+        this->mark_progress();
+        m_ivar_stamp[left_root] = m_stamp;
+        m_ivar_stamp[right_root] = m_stamp;
     }
 }
-HMTypeInferrence::IVar& HMTypeInferrence::get_pointed_ivar(unsigned int slot) const
+bool HMTypeInferrence::set_ivar_sized(unsigned int slot)
 {
-    auto index = slot;
-    unsigned int count = 0;
-    assert(index < m_ivars.size());
-    while( m_ivars.at(index).is_alias() ) {
-        index = m_ivars.at(index).alias;
-
-        if( count >= m_ivars.size() ) {
-            this->dump();
-            BUG(Span(), "Loop detected in ivar list when starting at " << slot << ", current is " << index);
-        }
-        count ++;
+    auto root = this->get_root(slot);
+    if( m_ivar_sized[root] )
+        return false;
+    m_ivar_sized[root] = true;
+    this->touch_ivar(root);
+    return true;
+}
+void HMTypeInferrence::touch_ivar(unsigned int slot)
+{
+    m_stamp ++;
+    m_ivar_stamp[this->get_pointed_ivar(slot)] = m_stamp;
+}
+unsigned int HMTypeInferrence::get_root(unsigned int slot) const
+{
+    assert(slot < m_ivar_parent.size());
+    auto root = slot;
+    while( m_ivar_parent[root] != root )
+        root = m_ivar_parent[root];
+    // Path compression: re-point every ivar on the path directly at the root
+    while( m_ivar_parent[slot] != root )
+    {
+        auto next = m_ivar_parent[slot];
+        m_ivar_parent[slot] = root;
+        slot = next;
     }
-    return const_cast<IVar&>(m_ivars.at(index));
+    return root;
+}
+unsigned int HMTypeInferrence::get_pointed_ivar(unsigned int slot) const
+{
+    auto index = this->get_root(slot);
+    if( m_read_log && (m_read_log->empty() || m_read_log->back() != index) )
+        m_read_log->push_back(index);
+    return index;
+}
+/// Merge two sets of ivars, `keep_root` stays the root (keeping its type and per-ivar state)
+/// - No union by rank, as path compression in `get_root` already keeps chains short
+void HMTypeInferrence::link_ivars(unsigned int keep_root, unsigned int other_root)
+{
+    assert(keep_root != other_root);
+    m_ivar_parent[other_root] = keep_root;
+    if( m_ivar_sized[other_root] )
+        m_ivar_sized[keep_root] = true;
+    // Leave the old root as an ivar naming the new one, so references to it (from `get_type`) still resolve
+    m_ivar_types[other_root] = ::HIR::TypeRef();
+    m_ivar_types[other_root].m_data.as_Infer().index = keep_root;
 }
 
 bool HMTypeInferrence::pathparams_contain_ivars(const ::HIR::PathParams& pps) const {
@@ -1575,37 +1591,34 @@ void TraitResolution::compact_ivars(HMTypeInferrence& m_ivars)
 {
     m_ivars.check_for_loops();
 
-    //m_ivars.compact_ivars([&](const ::HIR::TypeRef& t)->auto{ return this->expand_associated_types(Span(), t.clone); });
-    unsigned int i = 0;
-    for(auto& v : m_ivars.m_ivars)
+    // NOTE: Aliased ivars don't need visiting, their paths are compressed as they're looked up
+    for(unsigned int i = 0; i < m_ivars.ivar_count(); i ++)
     {
-        if( !v.is_alias() ) {
-            m_ivars.expand_ivars( *v.type );
-            // Don't expand unless it is needed
-            if( this->has_associated_type(*v.type) ) {
-                // TODO: cloning is expensive, BUT printing below is nice
-                auto nt = this->expand_associated_types(Span(), v.type->clone());
-                DEBUG("- " << i << " " << *v.type << " -> " << nt);
-                *v.type = mv$(nt);
+        if( !m_ivars.ivar_is_root(i) )
+            continue ;
+        auto& ty = m_ivars.ivar_root_type(i);
+        // Only expand if an inner ivar has been aliased/set (so the ivar's stamp is only updated if it changes)
+        bool needs_expand = visit_ty_with(ty, [&](const ::HIR::TypeRef& t)->bool {
+            if( const auto* e = t.m_data.opt_Infer() ) {
+                const auto& rt = m_ivars.get_type(t);
+                return !(rt.m_data.is_Infer() && rt.m_data.as_Infer().index == e->index && rt.m_data.as_Infer().ty_class == e->ty_class);
             }
-        }
-        else {
-
-            auto index = v.alias;
-            unsigned int count = 0;
-            assert(index < m_ivars.m_ivars.size());
-            while( m_ivars.m_ivars.at(index).is_alias() ) {
-                index = m_ivars.m_ivars.at(index).alias;
-
-                if( count >= m_ivars.m_ivars.size() ) {
-                    this->m_ivars.dump();
-                    BUG(Span(), "Loop detected in ivar list when starting at " << v.alias << ", current is " << index);
-                }
-                count ++;
+            return false;
+            });
+        if( needs_expand ) {
+            m_ivars.expand_ivars( ty );
+            m_ivars.touch_ivar(i);
+        }
+        // Don't expand unless it is needed
+        if( this->has_associated_type(ty) ) {
+            // TODO: cloning is expensive, BUT printing below is nice
+            auto nt = this->expand_associated_types(Span(), ty.clone());
+            DEBUG("- " << i << " " << ty << " -> " << nt);
+            if( nt != ty ) {
+                m_ivars.touch_ivar(i);
             }
-            v.alias = index;
+            ty = mv$(nt);
         }
-        i ++;
     }
 }
 
@@ -2456,14 +2469,16 @@ bool TraitResolution::find_trait_impls_bound(const Span& sp, const ::HIR::Simple
         return false;
     });
 }
+namespace {
+    // Protects `TraitMarkings::auto_impls` (a cache shared by all function bodies, which can be checked in parallel)
+    ::std::mutex    s_auto_impls_lock;
+}
 bool TraitResolution::find_trait_impls_crate(const Span& sp,
         const ::HIR::SimplePath& trait, const ::HIR::PathParams* params_ptr,
         const ::HIR::TypeRef& type,
         t_cb_trait_impl_r callback
         ) const
 {
-    // TODO: Have a global cache of impls that don't reference either generics or ivars
-
     static ::std::map<RcString, ::HIR::TypeRef>    null_assoc;
     TRACE_FUNCTION_F(trait << FMT_CB(ss, if(params_ptr) { ss << *params_ptr; } else { ss << "<?>"; }) << " for " << type);
 
@@ -2471,8 +2486,13 @@ bool TraitResolution::find_trait_impls_crate(const Span& sp,
     if( m_crate.get_trait_by_path(sp, trait).m_is_marker )
     {
         // Detect recursion and return true if detected
-        static ::std::vector< ::std::tuple< const ::HIR::SimplePath*, const ::HIR::PathParams*, const ::HIR::TypeRef*> >    stack;
-        for(const auto& ent : stack ) {
+        thread_local ::std::vector< ::std::tuple< const ::HIR::SimplePath*, const ::HIR::PathParams*, const ::HIR::TypeRef*> >    stack;
+        // Lowest stack depth that was assumed to hold by the above
+        // - Results that depend on an assumption about an outer query aren't cached, as they would depend on which
+        //   query happened to be made first (which isn't fixed when bodies are checked in parallel)
+        thread_local size_t assumed_depth = SIZE_MAX;
+        for(size_t i = 0; i < stack.size(); i ++) {
+            const auto& ent = stack[i];
             if( *::std::get<0>(ent) != trait )
                 continue ;
             if( ::std::get<1>(ent) && params_ptr && *::std::get<1>(ent) != *params_ptr )
@@ -2480,13 +2500,20 @@ bool TraitResolution::find_trait_impls_crate(const Span& sp,
             if( *::std::get<2>(ent) != type )
                 continue ;
 
+            assumed_depth = ::std::min(assumed_depth, i);
             return callback( ImplRef(&type, params_ptr, &null_assoc), ::HIR::Compare::Equal );
         }
+        size_t depth = stack.size();
         stack.push_back( ::std::make_tuple( &trait, params_ptr, &type ) );
         struct Guard {
-            ~Guard() { stack.pop_back(); }
+            size_t depth;
+            ~Guard() {
+                stack.pop_back();
+                if( assumed_depth >= depth )
+                    assumed_depth = SIZE_MAX;
+            }
         };
-        Guard   _;
+        Guard   _ { depth };
 
         // NOTE: Expected behavior is for Ivars to return false
         // TODO: Should they return Compare::Fuzzy instead?
@@ -2506,13 +2533,26 @@ bool TraitResolution::find_trait_impls_crate(const Span& sp,
         // - Cache populated after destructure
         if( markings )
         {
-            auto it = markings->auto_impls.find( trait );
-            if( it != markings->auto_impls.end() )
+            // NOTE: The entry is copied out, so the lock isn't held over the callback
+            bool    is_cached = false;
+            bool    is_conditional = false;
+            bool    is_impled = false;
+            {
+                ::std::lock_guard< ::std::mutex>    lh { s_auto_impls_lock };
+                auto it = markings->auto_impls.find( trait );
+                if( it != markings->auto_impls.end() )
+                {
+                    is_cached = true;
+                    is_conditional = !it->second.conditions.empty();
+                    is_impled = it->second.is_impled;
+                }
+            }
+            if( is_cached )
             {
-                if( ! it->second.conditions.empty() ) {
+                if( is_conditional ) {
                     TODO(sp, "Conditional auto trait impl");
                 }
-                else if( it->second.is_impled ) {
+                else if( is_impled ) {
                     return callback( ImplRef(&type, params_ptr, &null_assoc), ::HIR::Compare::Equal );
                 }
                 else {
@@ -2596,35 +2636,43 @@ bool TraitResolution::find_trait_impls_crate(const Span& sp,
         {
             if( markings ) {
                 ASSERT_BUG(sp, cmp == ::HIR::Compare::Equal, "Auto trait with no params returned a fuzzy match from destructure - " << trait << " for " << type);
-                markings->auto_impls.insert( ::std::make_pair(trait, ::HIR::TraitMarkings::AutoMarking { {}, true }) );
+                if( assumed_depth >= depth ) {
+                    ::std::lock_guard< ::std::mutex>    lh { s_auto_impls_lock };
+                    markings->auto_impls.insert( ::std::make_pair(trait, ::HIR::TraitMarkings::AutoMarking { {}, true }) );
+                }
             }
             return callback( ImplRef(&type, params_ptr, &null_assoc), cmp );
         }
         else
         {
-            if( markings ) {
+            if( markings && assumed_depth >= depth ) {
+                ::std::lock_guard< ::std::mutex>    lh { s_auto_impls_lock };
                 markings->auto_impls.insert( ::std::make_pair(trait, ::HIR::TraitMarkings::AutoMarking { {}, false }) );
             }
             return false;
         }
     }
 
-    return this->m_crate.find_trait_impls(trait, type, this->m_ivars.callback_resolve_infer(),
-        [&](const auto& impl) {
-            DEBUG("[find_trait_impls_crate] Found impl" << impl.m_params.fmt_args() << " " << trait << impl.m_trait_args << " for " << impl.m_type << " " << impl.m_params.fmt_bounds());
-            // Compare with `params`
-            ::std::vector< const ::HIR::TypeRef*> impl_params;
-            ::std::vector< ::HIR::TypeRef>  placeholders;
-            auto match = this->ftic_check_params(sp, trait,  params_ptr, type,  impl.m_params, impl.m_trait_args, impl.m_type,  impl_params, placeholders);
-            if( match == ::HIR::Compare::Unequal ) {
-                // If any bound failed, return false (continue searching)
-                DEBUG("[find_trait_impls_crate] - Params mismatch");
-                return false;
-            }
+    // NOTE: The search is given the cache's copy of the query when recording a cache entry (shadowing the arguments)
+    return ImplQueryCache::typeck().find(trait, params_ptr, type, callback,
+        [&](const ::HIR::SimplePath& trait, const ::HIR::PathParams* params_ptr, const ::HIR::TypeRef& type, t_cb_trait_impl_r callback)->bool {
+            return this->m_crate.find_trait_impls(trait, type, this->m_ivars.callback_resolve_infer(),
+                [&](const auto& impl) {
+                    DEBUG("[find_trait_impls_crate] Found impl" << impl.m_params.fmt_args() << " " << trait << impl.m_trait_args << " for " << impl.m_type << " " << impl.m_params.fmt_bounds());
+                    // Compare with `params`
+                    ::std::vector< const ::HIR::TypeRef*> impl_params;
+                    ::std::vector< ::HIR::TypeRef>  placeholders;
+                    auto match = this->ftic_check_params(sp, trait,  params_ptr, type,  impl.m_params, impl.m_trait_args, impl.m_type,  impl_params, placeholders);
+                    if( match == ::HIR::Compare::Unequal ) {
+                        // If any bound failed, return false (continue searching)
+                        DEBUG("[find_trait_impls_crate] - Params mismatch");
+                        return false;
+                    }
 
-            return callback(ImplRef(mv$(impl_params), trait, impl, mv$(placeholders)), match);
-        }
-        );
+                    return callback(ImplRef(mv$(impl_params), trait, impl, mv$(placeholders)), match);
+                }
+                );
+        });
 }
 
 ::HIR::Compare TraitResolution::check_auto_trait_impl_destructure(const Span& sp, const ::HIR::SimplePath& trait, const ::HIR::PathParams* params_ptr, const ::HIR::TypeRef& type) const
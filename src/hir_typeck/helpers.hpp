@@ -7,6 +7,7 @@
  */
 #pragma once
 
+#include <deque>
 #include <hir/hir.hpp>
 #include <hir/expr.hpp> // t_trait_list
 
@@ -55,25 +56,33 @@ public:
     };
 
 public: // ?? - Needed once, anymore?
-    struct IVar
-    {
-        //bool could_be_diverge;    // TODO: use this instead of InferClass::Diverge
-        unsigned int alias; // If not ~0, this points to another ivar
-        ::std::unique_ptr< ::HIR::TypeRef> type;    // Type (only nullptr if alias!=0)
-
-        IVar():
-            alias(~0u),
-            type(new ::HIR::TypeRef())
-        {}
-        bool is_alias() const { return alias != ~0u; }
-    };
+    // Ivar table, a union-find over ivar indexes (stored as parallel arrays)
+    // - Parent of each ivar, the ivar itself for the root of a set. Compressed during lookup.
+    mutable ::std::vector<unsigned int> m_ivar_parent;
+    // - Value of `m_stamp` when each ivar last changed
+    ::std::vector<unsigned long>    m_ivar_stamp;
+    // - Set if a root has been required to be Sized
+    ::std::vector<bool> m_ivar_sized;
+    // - Type of each root (an `Infer` holding the literal class until known), non-roots hold an `Infer` naming their root
+    //   NOTE: A deque so references returned by `get_type` stay valid when ivars are added
+    ::std::deque< ::HIR::TypeRef>   m_ivar_types;
 
-    ::std::vector< IVar>    m_ivars;
     bool    m_has_changed;
 
+    // Change stamps, used by the solver to skip rules that can't have been affected by recent changes
+    // - Incremented on every change
+    unsigned long   m_stamp;
+    // - Value of `m_stamp` at the last change to state outside of the ivar table (see `mark_change`)
+    unsigned long   m_external_stamp;
+    // If set, the root of every ivar looked up is pushed to this list
+    ::std::vector<unsigned int>*    m_read_log;
+
 public:
     HMTypeInferrence():
-        m_has_changed(false)
+        m_has_changed(false),
+        m_stamp(1),
+        m_external_stamp(1),
+        m_read_log(nullptr)
     {}
 
     bool peek_changed() const {
@@ -84,12 +93,28 @@ public:
         m_has_changed = false;
         return rv;
     }
+    /// Flag a change to state outside of the ivar table (e.g. rewritten expression nodes)
     void mark_change() {
+        mark_progress();
+        m_external_stamp = m_stamp;
+    }
+    /// Flag a change that existing rules can't depend on (e.g. adding a new rule)
+    void mark_progress() {
         if( !m_has_changed ) {
             DEBUG("- CHANGE");
             m_has_changed = true;
         }
+        m_stamp ++;
     }
+    /// Record that an ivar (or information attached to it) has changed, without flagging a change
+    void touch_ivar(unsigned int slot);
+
+    unsigned long stamp() const { return m_stamp; }
+    unsigned long external_stamp() const { return m_external_stamp; }
+    /// NOTE: `root` should be an index that was recorded by `set_read_log`
+    unsigned long ivar_stamp(unsigned int root) const { return m_ivar_stamp[root]; }
+    /// Set (or clear) the list that looked-up ivars are recorded in
+    void set_read_log(::std::vector<unsigned int>* log) { m_read_log = log; }
 
     void compact_ivars();
     bool apply_defaults();
@@ -125,6 +150,9 @@ public:
     ::HIR::TypeRef new_ivar_tr();
     void set_ivar_to(unsigned int slot, ::HIR::TypeRef type);
     void ivar_unify(unsigned int left_slot, unsigned int right_slot);
+    /// Flag an ivar as required to be Sized (returns false if it already was)
+    bool set_ivar_sized(unsigned int slot);
+    bool ivar_is_sized(unsigned int slot) const { return m_ivar_sized[get_root(slot)]; }
 
     // Lookup
     ::HIR::TypeRef& get_type(::HIR::TypeRef& type);
@@ -139,8 +167,15 @@ public:
     bool type_contains_ivars(const ::HIR::TypeRef& ty) const;
     bool pathparams_equal(const ::HIR::PathParams& pps_l, const ::HIR::PathParams& pps_r) const;
     bool types_equal(const ::HIR::TypeRef& l, const ::HIR::TypeRef& r) const;
+
+    size_t ivar_count() const { return m_ivar_parent.size(); }
+    bool ivar_is_root(unsigned int slot) const { return m_ivar_parent[slot] == slot; }
+    /// Type stored in a root ivar
+    ::HIR::TypeRef& ivar_root_type(unsigned int root) { assert(ivar_is_root(root)); return m_ivar_types[root]; }
 private:
-    IVar& get_pointed_ivar(unsigned int slot) const;
+    unsigned int get_root(unsigned int slot) const;
+    unsigned int get_pointed_ivar(unsigned int slot) const;
+    void link_ivars(unsigned int keep_root, unsigned int other_root);
 };
 
 class TraitResolution
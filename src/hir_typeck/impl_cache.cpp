@@ -0,0 +1,172 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * hir_typeck/impl_cache.cpp
+ * - Crate-wide memoisation of trait impl searches
+ */
+#include "impl_cache.hpp"
+#include "common.hpp"   // visit_ty_with
+
+namespace {
+    ImplQueryCache  g_typeck_cache;
+    ImplQueryCache  g_static_cache;
+}
+
+ImplQueryCache& ImplQueryCache::typeck()
+{
+    return g_typeck_cache;
+}
+ImplQueryCache& ImplQueryCache::static_resolve()
+{
+    return g_static_cache;
+}
+void ImplQueryCache::clear_all()
+{
+    g_typeck_cache.clear();
+    g_static_cache.clear();
+}
+void ImplQueryCache::release_retired_all()
+{
+    g_typeck_cache.release_retired();
+    g_static_cache.release_retired();
+}
+void ImplQueryCache::get_stats(::std::vector< ::std::pair<const char*, size_t> >& out)
+{
+    out.push_back(::std::make_pair("impl_cache_typeck_hits", g_typeck_cache.m_hits.load()));
+    out.push_back(::std::make_pair("impl_cache_typeck_misses", g_typeck_cache.m_misses.load()));
+    out.push_back(::std::make_pair("impl_cache_typeck_uncached", g_typeck_cache.m_uncached.load()));
+    out.push_back(::std::make_pair("impl_cache_static_hits", g_static_cache.m_hits.load()));
+    out.push_back(::std::make_pair("impl_cache_static_misses", g_static_cache.m_misses.load()));
+    out.push_back(::std::make_pair("impl_cache_static_uncached", g_static_cache.m_uncached.load()));
+}
+
+bool ImplQueryCache::query_is_cacheable(const ::HIR::PathParams* params, const ::HIR::TypeRef& type)
+{
+    auto cb = [](const ::HIR::TypeRef& ty)->bool {
+        // - Ivars and generics depend on the current function
+        if( ty.m_data.is_Infer() || ty.m_data.is_Generic() )
+            return true;
+        // - Closure classes are filled in during typecheck, and erased types are replaced after it
+        if( ty.m_data.is_Closure() || ty.m_data.is_ErasedType() )
+            return true;
+        // - Associated types could resolve to anything
+        if( const auto* e = ty.m_data.opt_Path() )
+        {
+            if( !e->path.m_data.is_Generic() || e->binding.is_Unbound() || e->binding.is_Opaque() )
+                return true;
+        }
+        return false;
+        };
+    if( visit_ty_with(type, cb) )
+        return false;
+    if( params )
+    {
+        for(const auto& ty : params->m_types)
+            if( visit_ty_with(ty, cb) )
+                return false;
+    }
+    return true;
+}
+
+bool ImplQueryCache::find(const ::HIR::SimplePath& trait, const ::HIR::PathParams* params, const ::HIR::TypeRef& type, t_cb_impl callback, t_cb_search search)
+{
+    if( !query_is_cacheable(params, type) )
+    {
+        m_uncached ++;
+        return search(trait, params, type, callback);
+    }
+
+    size_t hash = hash_combine(hash_combine(trait.hash(), params ? params->hash() : 0), type.hash());
+    Entry*  ent = nullptr;
+    {
+        ::std::lock_guard< ::std::mutex>    lh { m_lock };
+        auto range = m_entries.equal_range(hash);
+        for(auto it = range.first; it != range.second; ++ it)
+        {
+            const auto& e = *it->second;
+            if( e.trait == trait && e.has_params == (params != nullptr) && (!params || e.params == *params) && e.type == type )
+            {
+                ent = it->second.get();
+                break;
+            }
+        }
+        if( !ent )
+        {
+            auto new_ent = ::std::unique_ptr<Entry>(new Entry());
+            new_ent->trait = trait;
+            new_ent->has_params = (params != nullptr);
+            if( params )
+                new_ent->params = params->clone();
+            new_ent->type = type.clone();
+            ent = new_ent.get();
+            m_entries.insert(::std::make_pair( hash, mv$(new_ent) ));
+        }
+    }
+
+    // Complete entries are never modified, so can be read without locking
+    if( ent->complete.load(::std::memory_order_acquire) )
+    {
+        m_hits ++;
+        for(const auto& c : ent->candidates)
+        {
+            if( callback(c.first.clone(), c.second) )
+                return true;
+        }
+        return false;
+    }
+
+    // Incomplete: take ownership of the entry so it can be extended, or search directly if it's already being used
+    // (by another thread, or by a recursive query for the same impl)
+    bool expected = false;
+    if( !ent->busy.compare_exchange_strong(expected, true) )
+    {
+        m_uncached ++;
+        return search(trait, params, type, callback);
+    }
+    struct Guard {
+        Entry& e;
+        ~Guard() { e.busy.store(false); }
+    } guard { *ent };
+
+    for(const auto& c : ent->candidates)
+    {
+        if( callback(c.first.clone(), c.second) )
+        {
+            m_hits ++;
+            return true;
+        }
+    }
+
+    // None of the known candidates were accepted, search again (skipping those already offered)
+    // - The search uses the entry's copy of the query, so pointers within the recorded `ImplRef`s stay valid
+    m_misses ++;
+    size_t n_known = ent->candidates.size();
+    size_t idx = 0;
+    bool rv = search(ent->trait, ent->has_params ? &ent->params : nullptr, ent->type, [&](ImplRef impl, ::HIR::Compare cmp)->bool {
+        if( idx++ < n_known )
+            return false;
+        ent->candidates.push_back(::std::make_pair( impl.clone(), cmp ));
+        return callback(mv$(impl), cmp);
+        });
+    if( !rv )
+    {
+        ent->complete.store(true, ::std::memory_order_release);
+    }
+    return rv;
+}
+
+void ImplQueryCache::clear()
+{
+    ::std::lock_guard< ::std::mutex>    lh { m_lock };
+    m_retired.reserve(m_retired.size() + m_entries.size());
+    for(auto& e : m_entries)
+        m_retired.push_back( mv$(e.second) );
+    m_entries.clear();
+}
+void ImplQueryCache::release_retired()
+{
+    ::std::lock_guard< ::std::mutex>    lh { m_lock };
+    m_retired.clear();
+    m_retired.shrink_to_fit();
+}
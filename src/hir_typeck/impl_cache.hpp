@@ -0,0 +1,83 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * hir_typeck/impl_cache.hpp
+ * - Crate-wide memoisation of trait impl searches
+ */
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <hir/hir.hpp>
+#include "impl_ref.hpp"
+
+/// Cache of crate impl searches for a `(trait, params, type)` query
+///
+/// Only queries that can't depend on the calling context are cached (no ivars, generics, closures, erased types or
+/// unresolved paths), so one cache serves every function body in the crate. Each entry records the candidates the search
+/// passed to its callback, in order. A later query replays them until its callback accepts one, and only searches again
+/// if none are accepted and the recorded search had stopped early. Once a search has run to the end the entry is
+/// complete, and the query (including a negative result) is answered without searching.
+///
+/// NOTE: Only valid for searches that return `true` exactly when the callback accepts a candidate.
+class ImplQueryCache
+{
+public:
+    typedef ::std::function<bool(ImplRef, ::HIR::Compare)>  t_cb_impl;
+    /// Performs the uncached search (passed the cache's copy of the query when recording)
+    typedef ::std::function<bool(const ::HIR::SimplePath& trait, const ::HIR::PathParams* params, const ::HIR::TypeRef& type, t_cb_impl callback)>  t_cb_search;
+
+private:
+    struct Entry
+    {
+        ::HIR::SimplePath   trait;
+        bool    has_params;
+        ::HIR::PathParams   params;
+        ::HIR::TypeRef  type;
+
+        ::std::vector< ::std::pair<ImplRef, ::HIR::Compare> >  candidates;
+        // Set once `candidates` is the full result (after which the entry isn't modified)
+        ::std::atomic<bool> complete { false };
+        // Held while replaying/extending an incomplete entry
+        ::std::atomic<bool> busy { false };
+    };
+
+    ::std::mutex    m_lock;
+    ::std::unordered_multimap<size_t, ::std::unique_ptr<Entry>>    m_entries;
+    // Entries dropped by `clear`, kept alive until `release_retired` as `ImplRef`s handed out from them point into
+    // their query types
+    ::std::vector< ::std::unique_ptr<Entry> >  m_retired;
+    ::std::atomic<size_t>   m_hits { 0 };
+    ::std::atomic<size_t>   m_misses { 0 };
+    ::std::atomic<size_t>   m_uncached { 0 };
+
+public:
+    /// Search for impls of `trait` for `type`, using the cache if possible
+    bool find(const ::HIR::SimplePath& trait, const ::HIR::PathParams* params, const ::HIR::TypeRef& type, t_cb_impl callback, t_cb_search search);
+    /// Drop all entries (so they're no longer used for lookups), called when impls are added to the crate
+    /// - The entries themselves are retired instead of freed, so `ImplRef`s obtained from them stay valid.
+    /// NOTE: Must not be called while searches are running.
+    void clear();
+    /// Free the entries retired by `clear`
+    /// NOTE: Must only be called once no `ImplRef` obtained from the cache is alive (i.e. between compiler phases)
+    void release_retired();
+
+    /// Cache for `TraitResolution::find_trait_impls_crate` (expression typecheck)
+    static ImplQueryCache& typeck();
+    /// Cache for `StaticTraitResolve::find_impl`
+    static ImplQueryCache& static_resolve();
+    /// Clear both caches
+    static void clear_all();
+    /// Free the retired entries of both caches, called at the end of each compiler phase
+    static void release_retired_all();
+    /// Hit/miss counters of both caches (for `--phase-stats`)
+    static void get_stats(::std::vector< ::std::pair<const char*, size_t> >& out);
+
+private:
+    static bool query_is_cacheable(const ::HIR::PathParams* params, const ::HIR::TypeRef& type);
+};
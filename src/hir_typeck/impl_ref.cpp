@@ -83,6 +83,33 @@ bool ImplRef::overlaps_with(const ::HIR::Crate& crate, const ImplRef& other) con
     )
     return false;
 }
+ImplRef ImplRef::clone() const
+{
+    TU_MATCH_HDRA( (this->m_data), {)
+    TU_ARMA(TraitImpl, e) {
+        if( e.impl == nullptr ) {
+            return ImplRef();
+        }
+        ::std::vector< ::HIR::TypeRef>  params_ph;
+        params_ph.reserve(e.params_ph.size());
+        for(const auto& t : e.params_ph)
+            params_ph.push_back( t.clone() );
+        ImplRef rv { e.params, *e.trait_path, *e.impl, mv$(params_ph) };
+        rv.m_data.as_TraitImpl().self_cache = e.self_cache.clone();
+        return rv;
+        }
+    TU_ARMA(BoundedPtr, e) {
+        return ImplRef(e.type, e.trait_args, e.assoc);
+        }
+    TU_ARMA(Bounded, e) {
+        ::std::map< RcString, ::HIR::TypeRef>   assoc;
+        for(const auto& a : e.assoc)
+            assoc.insert( ::std::make_pair(a.first, a.second.clone()) );
+        return ImplRef(e.type.clone(), e.trait_args.clone(), mv$(assoc));
+        }
+    }
+    throw "";
+}
 bool ImplRef::has_magic_params() const
 {
     TU_IFLET(Data, m_data, TraitImpl, e,
@@ -52,6 +52,9 @@ struct ImplRef
         m_data(Data::make_Bounded({ mv$(type), mv$(args), mv$(assoc) }))
     {}
 
+    /// Deep copy (pointers to the impl/bound data are shared, owned data is cloned)
+    ImplRef clone() const;
+
     bool is_valid() const {
         return !(m_data.is_TraitImpl() && m_data.as_TraitImpl().impl == nullptr);
     }
@@ -6,6 +6,7 @@
  * - Non-inferred type checking
  */
 #include "static.hpp"
+#include "impl_cache.hpp"
 #include <algorithm>
 #include <hir/expr.hpp>
 
@@ -16,7 +17,10 @@ void StaticTraitResolve::prep_indexes()
 
     TRACE_FUNCTION_F("");
 
-    m_copy_cache.clear();
+    {
+        ::std::lock_guard< ::std::mutex>    lh { m_cache_lock };
+        m_copy_cache.clear();
+    }
 
     auto add_equality = [&](::HIR::TypeRef long_ty, ::HIR::TypeRef short_ty){
         DEBUG("[prep_indexes] ADD " << long_ty << " => " << short_ty);
@@ -431,7 +435,7 @@ bool StaticTraitResolve::find_impl(
             return rv;
 
         // Detect recursion and return true if detected
-        static ::std::vector< ::std::tuple< const ::HIR::SimplePath*, const ::HIR::PathParams*, const ::HIR::TypeRef*> >    stack;
+        thread_local ::std::vector< ::std::tuple< const ::HIR::SimplePath*, const ::HIR::PathParams*, const ::HIR::TypeRef*> >    stack;
         for(const auto& ent : stack ) {
             if( *::std::get<0>(ent) != trait_path )
                 continue ;
@@ -456,8 +460,17 @@ bool StaticTraitResolve::find_impl(
     else
     {
         // Search the crate for impls
-        ret = m_crate.find_trait_impls(trait_path, type, cb_ident, [&](const auto& impl) {
-            return this->find_impl__check_crate(sp, trait_path, trait_params, type, found_cb,  impl);
+        // - Memoised crate-wide (the search is given the cache's copy of the query when recording an entry)
+        ret = ImplQueryCache::static_resolve().find(trait_path, trait_params, type,
+            [&](ImplRef impl, ::HIR::Compare cmp) {
+                return found_cb(mv$(impl), cmp == ::HIR::Compare::Fuzzy);
+            },
+            [&](const ::HIR::SimplePath& trait_path, const ::HIR::PathParams* trait_params, const ::HIR::TypeRef& type, ImplQueryCache::t_cb_impl callback)->bool {
+                return m_crate.find_trait_impls(trait_path, type, cb_ident, [&](const auto& impl) {
+                    return this->find_impl__check_crate(sp, trait_path, trait_params, type, [&](ImplRef ir, bool is_fuzzed) {
+                            return callback(mv$(ir), is_fuzzed ? ::HIR::Compare::Fuzzy : ::HIR::Compare::Equal);
+                        },  impl);
+                    });
             });
         if(ret)
             return true;
@@ -1458,22 +1471,37 @@ bool StaticTraitResolve::trait_contains_type(const Span& sp, const ::HIR::Generi
     return false;
 }
 
+bool StaticTraitResolve::cache_lookup(const ::std::unordered_map< ::HIR::TypeRef, bool>& cache, const ::HIR::TypeRef& ty, bool& out_value) const
+{
+    ::std::lock_guard< ::std::mutex>    lh { m_cache_lock };
+    auto it = cache.find(ty);
+    if( it == cache.end() )
+        return false;
+    out_value = it->second;
+    return true;
+}
+void StaticTraitResolve::cache_insert(::std::unordered_map< ::HIR::TypeRef, bool>& cache, const ::HIR::TypeRef& ty, bool value) const
+{
+    ::std::lock_guard< ::std::mutex>    lh { m_cache_lock };
+    cache.insert(::std::make_pair( ty.clone(), value ));
+}
+
 bool StaticTraitResolve::type_is_copy(const Span& sp, const ::HIR::TypeRef& ty) const
 {
     TU_MATCH(::HIR::TypeRef::Data, (ty.m_data), (e),
     (Generic,
         {
-            auto it = m_copy_cache.find(ty);
-            if( it != m_copy_cache.end() )
+            bool cached;
+            if( this->cache_lookup(m_copy_cache, ty, cached) )
             {
-                return it->second;
+                return cached;
             }
         }
         bool rv = this->iterate_bounds([&](const auto& b)->bool {
             auto pp = ::HIR::PathParams();
             return this->find_impl__check_bound(sp, m_lang_Copy, &pp, ty, [&](auto , bool ){ return true; },  b);
             });
-        m_copy_cache.insert(::std::make_pair( ty.clone(), rv ));
+        this->cache_insert(m_copy_cache, ty, rv);
         return rv;
         ),
     (Path,
@@ -1497,13 +1525,13 @@ bool StaticTraitResolve::type_is_copy(const Span& sp, const ::HIR::TypeRef& ty)
         }
 
         {
-            auto it = m_copy_cache.find(ty);
-            if( it != m_copy_cache.end() )
-                return it->second;
+            bool cached;
+            if( this->cache_lookup(m_copy_cache, ty, cached) )
+                return cached;
         }
         auto pp = ::HIR::PathParams();
         bool rv = this->find_impl(sp, m_lang_Copy, &pp, ty, [&](auto , bool){ return true; }, true);
-        m_copy_cache.insert(::std::make_pair( ty.clone(), rv ));
+        this->cache_insert(m_copy_cache, ty, rv);
         return rv;
         ),
     (Diverge,
@@ -1574,35 +1602,35 @@ bool StaticTraitResolve::type_is_clone(const Span& sp, const ::HIR::TypeRef& ty)
     TU_MATCH(::HIR::TypeRef::Data, (ty.m_data), (e),
     (Generic,
         {
-            auto it = m_clone_cache.find(ty);
-            if( it != m_clone_cache.end() )
+            bool cached;
+            if( this->cache_lookup(m_clone_cache, ty, cached) )
             {
-                return it->second;
+                return cached;
             }
         }
         bool rv = this->iterate_bounds([&](const auto& b)->bool {
             auto pp = ::HIR::PathParams();
             return this->find_impl__check_bound(sp, m_lang_Clone, &pp, ty, [&](auto , bool ){ return true; },  b);
             });
-        m_clone_cache.insert(::std::make_pair( ty.clone(), rv ));
+        this->cache_insert(m_clone_cache, ty, rv);
         return rv;
         ),
     (Path,
         if(true) {
-            auto it = m_clone_cache.find(ty);
-            if( it != m_clone_cache.end() )
-                return it->second;
+            bool cached;
+            if( this->cache_lookup(m_clone_cache, ty, cached) )
+                return cached;
         }
         if( e.is_closure() )
         {
             bool rv = true;
             // TODO: Check all captures
-            m_clone_cache.insert(::std::make_pair( ty.clone(), rv ));
+            this->cache_insert(m_clone_cache, ty, rv);
             return rv;
         }
         auto pp = ::HIR::PathParams();
         bool rv = this->find_impl(sp, m_lang_Clone, &pp, ty, [&](auto , bool){ return true; }, true);
-        m_clone_cache.insert(::std::make_pair( ty.clone(), rv ));
+        this->cache_insert(m_clone_cache, ty, rv);
         return rv;
         ),
     (Diverge,
@@ -2096,17 +2124,17 @@ bool StaticTraitResolve::type_needs_drop_glue(const Span& sp, const ::HIR::TypeR
             return false;
         }
 
-        auto it = m_drop_cache.find(ty);
-        if( it != m_drop_cache.end() )
+        bool cached;
+        if( this->cache_lookup(m_drop_cache, ty, cached) )
         {
-            return it->second;
+            return cached;
         }
 
         auto pp = ::HIR::PathParams();
         bool has_direct_drop = this->find_impl(sp, m_lang_Drop, &pp, ty, [&](auto , bool){ return true; }, true);
         if( has_direct_drop )
         {
-            m_drop_cache.insert(::std::make_pair(ty.clone(), true));
+            this->cache_insert(m_drop_cache, ty, true);
             return true;
         }
 
@@ -2180,7 +2208,7 @@ bool StaticTraitResolve::type_needs_drop_glue(const Span& sp, const ::HIR::TypeR
             needs_drop_glue = false;
             )
         )
-        m_drop_cache.insert(::std::make_pair(ty.clone(), needs_drop_glue));
+        this->cache_insert(m_drop_cache, ty, needs_drop_glue);
         return needs_drop_glue;
         ),
     (Diverge,
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include <mutex>
+#include <unordered_map>
 #include <hir/hir.hpp>
 #include "common.hpp"
 #include "impl_ref.hpp"
@@ -42,9 +44,20 @@ public:
     ::HIR::SimplePath   m_lang_PhantomData;
 
 private:
-    mutable ::std::map< ::HIR::TypeRef, bool >  m_copy_cache;
-    mutable ::std::map< ::HIR::TypeRef, bool >  m_clone_cache;
-    mutable ::std::map< ::HIR::TypeRef, bool >  m_drop_cache;
+    // NOTE: The resolver can be shared between threads (e.g. during monomorphisation), so the caches are locked
+    // - Moving the resolver gives the new instance a fresh lock (it can't be in use by other threads while being moved)
+    struct CacheLock: public ::std::mutex {
+        CacheLock() {}
+        CacheLock(CacheLock&& ) {}
+        CacheLock& operator=(CacheLock&& ) { return *this; }
+    };
+    mutable CacheLock   m_cache_lock;
+    mutable ::std::unordered_map< ::HIR::TypeRef, bool >  m_copy_cache;
+    mutable ::std::unordered_map< ::HIR::TypeRef, bool >  m_clone_cache;
+    mutable ::std::unordered_map< ::HIR::TypeRef, bool >  m_drop_cache;
+
+    bool cache_lookup(const ::std::unordered_map< ::HIR::TypeRef, bool>& cache, const ::HIR::TypeRef& ty, bool& out_value) const;
+    void cache_insert(::std::unordered_map< ::HIR::TypeRef, bool>& cache, const ::HIR::TypeRef& ty, bool value) const;
 
 public:
     StaticTraitResolve(const ::HIR::Crate& crate):
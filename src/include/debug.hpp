@@ -12,7 +12,7 @@
 #include <cassert>
 #include <functional>
 
-extern int g_debug_indent_level;
+extern thread_local int g_debug_indent_level;
 
 #ifndef DEBUG_EXTRA_ENABLE
 # define DEBUG_EXTRA_ENABLE  // Files can override this with their own flag if needed (e.g. `&& g_my_debug_on`)
@@ -24,8 +24,8 @@ extern int g_debug_indent_level;
 # define UNINDENT()    do { g_debug_indent_level -= 1; } while(0)
 # define DEBUG(ss)   do{ if(DEBUG_ENABLED) { debug_output(g_debug_indent_level, __FUNCTION__) << ss << ::std::endl; } } while(0)
 # define TRACE_FUNCTION  TraceLog _tf_( DEBUG_ENABLED ? __func__ : nullptr)
-# define TRACE_FUNCTION_F(ss)    TraceLog _tf_(DEBUG_ENABLED ? __func__ : nullptr, [&](::std::ostream&__os){ __os << ss; })
-# define TRACE_FUNCTION_FR(ss,ss2)    TraceLog _tf_(DEBUG_ENABLED ? __func__ : nullptr, [&](::std::ostream&__os){ __os << ss; }, [&](::std::ostream&__os){ __os << ss2;})
+# define TRACE_FUNCTION_F(ss)    auto _tf_ = TraceLog_d(DEBUG_ENABLED ? __func__ : nullptr, [&](::std::ostream&__os){ __os << ss; })
+# define TRACE_FUNCTION_FR(ss,ss2)    auto _tf_ = TraceLog_d(DEBUG_ENABLED ? __func__ : nullptr, [&](::std::ostream&__os){ __os << ss; }, [&](::std::ostream&__os){ __os << ss2;})
 #else
 # define INDENT()    do { } while(0)
 # define UNINDENT()    do {} while(0)
@@ -37,6 +37,10 @@ extern int g_debug_indent_level;
 
 extern bool debug_enabled();
 extern ::std::ostream& debug_output(int indent, const char* function);
+/// Stream for debug output on the current thread (a per-task buffer on worker threads, otherwise stdout)
+extern ::std::ostream& debug_stream();
+/// Write out the current thread's buffered trace output now (used before the process is stopped by a fatal error)
+extern void debug_flush_buffered();
 
 struct RepeatLitStr
 {
@@ -60,16 +64,73 @@ public:
     const NullSink& operator<<(const T&) const { return *this;  }
 };
 
+/// Function entry/exit tracing (see TRACE_FUNCTION*)
+/// - A null tag disables the output, the indent level is still changed (so the nesting depth is always tracked)
 class TraceLog
 {
     const char* m_tag;
-    ::std::function<void(::std::ostream&)>  m_ret;
 public:
-    TraceLog(const char* tag, ::std::function<void(::std::ostream&)> info_cb, ::std::function<void(::std::ostream&)> ret);
-    TraceLog(const char* tag, ::std::function<void(::std::ostream&)> info_cb);
     TraceLog(const char* tag);
     ~TraceLog();
+
+    // Out-of-line parts of the enabled path, shared with `TraceLogT`
+    static ::std::ostream& enter_begin(const char* tag);
+    static void enter_end(::std::ostream& os);
+    static ::std::ostream& exit_begin(const char* tag);
+    static void exit_end(::std::ostream& os);
+};
+/// Function trace with formatting callbacks (stored by value, so there's no allocation or type erasure)
+template<typename RetCb>
+class TraceLogT
+{
+    const char* m_tag;
+    RetCb   m_ret;
+    // Cleared when moved from
+    bool    m_active;
+public:
+    template<typename InfoCb>
+    TraceLogT(const char* tag, const InfoCb& info_cb, RetCb ret):
+        m_tag(tag),
+        m_ret(::std::move(ret)),
+        m_active(true)
+    {
+        if(m_tag) {
+            auto& os = TraceLog::enter_begin(m_tag);
+            info_cb(os);
+            TraceLog::enter_end(os);
+        }
+        INDENT();
+    }
+    TraceLogT(TraceLogT&& x):
+        m_tag(x.m_tag),
+        m_ret(::std::move(x.m_ret)),
+        m_active(x.m_active)
+    {
+        x.m_active = false;
+    }
+    TraceLogT(const TraceLogT&) = delete;
+    ~TraceLogT() {
+        if(!m_active)
+            return ;
+        UNINDENT();
+        if(m_tag) {
+            auto& os = TraceLog::exit_begin(m_tag);
+            m_ret(os);
+            TraceLog::exit_end(os);
+        }
+    }
+};
+struct TraceLogNoRet {
+    void operator()(::std::ostream& ) const {}
 };
+template<typename InfoCb, typename RetCb>
+TraceLogT<RetCb> TraceLog_d(const char* tag, const InfoCb& info_cb, RetCb ret) {
+    return TraceLogT<RetCb>(tag, info_cb, ::std::move(ret));
+}
+template<typename InfoCb>
+TraceLogT<TraceLogNoRet> TraceLog_d(const char* tag, const InfoCb& info_cb) {
+    return TraceLogT<TraceLogNoRet>(tag, info_cb, TraceLogNoRet());
+}
 
 struct FmtLambda
 {
@@ -2,15 +2,53 @@
  */
 #pragma once
 #include <ctime>
+#include <chrono>
 #include <initializer_list>
+#include <iosfwd>
+#include <functional>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
 
 extern void debug_init_phases(const char* env_var_name, std::initializer_list<const char*> il);
 
+/// Enable per-phase statistics (`--phase-stats`), the JSON file at `path` is re-written at the end of each phase
+extern void debug_enable_phase_stats(::std::string path);
+/// Set the callback used to count items (functions, types, ...) at the end of each phase for the phase stats
+typedef ::std::function<void(::std::vector< ::std::pair<const char*, size_t> >&)>   t_debug_item_counter;
+extern void debug_set_phase_item_counter(t_debug_item_counter cb);
+
 class DebugTimedPhase
 {
     const char* m_name;
-    clock_t m_start;
+    double  m_cpu_start;
+    ::std::chrono::steady_clock::time_point m_wall_start;
+    // Only populated if phase stats are enabled
+    uint64_t    m_peak_rss_start;
+    uint64_t    m_alloc_count_start;
+    uint64_t    m_alloc_bytes_start;
 public:
     DebugTimedPhase(const char* name);
     ~DebugTimedPhase();
 };
+
+/// Installs the debug/trace state of another thread (the one that spawned a parallel task) on the current thread
+/// - Trace output is redirected to `sink` (if non-null) so it can be merged in a fixed order once the task completes
+class DebugThreadContext
+{
+    int m_saved_indent;
+    bool    m_saved_enabled;
+    ::std::ostringstream*   m_saved_sink;
+public:
+    struct State {
+        int indent_level;
+        bool    enabled;
+    };
+    /// Get the current thread's state, to be passed to worker threads
+    static State capture();
+
+    DebugThreadContext(const State& parent, ::std::ostringstream* sink);
+    DebugThreadContext(const DebugThreadContext&) = delete;
+    ~DebugThreadContext();
+};
@@ -7,13 +7,38 @@
  */
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <ostream>
+#include <string>
+#include <vector>
 #include "../common.hpp"
 
 class RcString
 {
-    unsigned int*   m_ptr;
+    /// Start of the allocation, followed by the NUL-terminated string data
+    struct Header {
+        /// Reference count (atomic, as strings are shared between worker threads)
+        ::std::atomic<unsigned int> refcount;
+        /// Length, with `INTERNED_FLAG` set for the instance owned by the intern table
+        unsigned int    size;
+
+        Header(unsigned int size): refcount(1), size(size) {}
+        const char* data() const { return reinterpret_cast<const char*>(this + 1); }
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+    };
+    Header* m_ptr;
+
+    static const unsigned int INTERNED_FLAG = 1u << 31;
+
+    static void inc_ref(Header* p) {
+        p->refcount.fetch_add(1, ::std::memory_order_relaxed);
+    }
+    /// Returns true if this was the last reference
+    static bool dec_ref(Header* p) {
+        return p->refcount.fetch_sub(1, ::std::memory_order_acq_rel) == 1;
+    }
+    static RcString new_interned_locked(const char* s, size_t len);
 public:
     RcString():
         m_ptr(nullptr)
@@ -28,13 +53,21 @@ public:
     {
     }
 
-    static RcString new_interned(const ::std::string& s);
-    static RcString new_interned(const char* s);
+    /// Get the process-wide shared instance of a string (interned strings are equal only if they are the same instance)
+    static RcString new_interned(const char* s, size_t len);
+    static RcString new_interned(const ::std::string& s) {
+        return new_interned(s.data(), s.size());
+    }
+    static RcString new_interned(const char* s) {
+        return new_interned(s, ::std::strlen(s));
+    }
+    /// Intern a list of strings (e.g. a metadata string table) under a single lock
+    static ::std::vector<RcString> new_interned_list(const ::std::vector<::std::string>& strings);
 
     RcString(const RcString& x):
         m_ptr(x.m_ptr)
     {
-        if( m_ptr ) *m_ptr += 1;
+        if( m_ptr ) inc_ref(m_ptr);
     }
     RcString(RcString&& x):
         m_ptr(x.m_ptr)
@@ -50,7 +83,7 @@ public:
         {
             this->~RcString();
             m_ptr = x.m_ptr;
-            if( m_ptr ) *m_ptr += 1;
+            if( m_ptr ) inc_ref(m_ptr);
         }
         return *this;
     }
@@ -68,11 +101,12 @@ public:
     const char* begin() const { return c_str(); }
     const char* end() const { return c_str() + size(); }
 
-    size_t size() const { return m_ptr ? m_ptr[1] : 0; }
+    size_t size() const { return m_ptr ? (m_ptr->size & ~INTERNED_FLAG) : 0; }
+    bool is_interned() const { return m_ptr && (m_ptr->size & INTERNED_FLAG); }
     const char* c_str() const {
         if( m_ptr )
         {
-            return reinterpret_cast<const char*>(m_ptr + 2);
+            return m_ptr->data();
         }
         else
         {
@@ -92,14 +126,16 @@ public:
         return ord(s.c_str(), s.size());
     }
     bool operator==(const RcString& s) const {
+        if( m_ptr == s.m_ptr )
+            return true;
+        if( this->is_interned() && s.is_interned() )
+            return false;
         if(s.size() != this->size())
             return false;
         return this->ord(s) == OrdEqual;
     }
     bool operator!=(const RcString& s) const {
-        if(s.size() != this->size())
-            return true;
-        return this->ord(s) != OrdEqual;
+        return !(*this == s);
     }
     bool operator<(const RcString& s) const { return this->ord(s) == OrdLess; }
     bool operator>(const RcString& s) const { return this->ord(s) == OrdGreater; }
@@ -10,6 +10,8 @@
 #include <rc_string.hpp>
 #include <functional>
 #include <memory>
+#include <cstdint>
+#include <vector>
 
 enum ErrorType
 {
@@ -29,31 +31,35 @@ struct ProtoSpan
     unsigned int start_line;
     unsigned int start_ofs;
 };
+struct SpanData;
+/// Source location, a handle into the global source map (see `SpanData`)
+///
+/// Spans are copied into most AST/HIR/MIR nodes, so are kept to a single integer. The location data is only
+/// looked up when needed (e.g. when printing an error).
+///
+/// Source map entries are never freed, so it grows with every span created (by parsing, macro expansion and each
+/// pass that makes new spans) until the process exits. Creating a span that matches a recently created one reuses
+/// that entry, but this only catches some duplicates (see `Span::get_stats`, reported by `--phase-stats`).
+/// The map is limited to 2^32 entries.
 struct Span
 {
 //public:
-    ::std::shared_ptr<Span> outer_span; // Expansion target for macros
-    RcString    filename;
-
-    unsigned int start_line;
-    unsigned int start_ofs;
-    unsigned int end_line;
-    unsigned int end_ofs;
+    /// Index into the source map, 0 is the empty span
+    uint32_t    m_idx;
 
-    Span(RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs):
-        filename( ::std::move(filename) ),
-        start_line(start_line),
-        start_ofs(start_ofs),
-        end_line(end_line),
-        end_ofs(end_ofs)
-    {}
-    Span(const Span& x) = default;
-    Span(Span&& x) = default;
+    Span(RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs);
+    /// Span within a macro expansion, with `outer_span` being the macro invocation
+    Span(const Span& outer_span, RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs);
     Span(const Position& position);
-    Span();
+    Span(const Span& outer_span, const Position& position);
+    Span():
+        m_idx(0)
+    {}
 
-    Span& operator=(const Span& x) = default;
-    Span& operator=(Span&& x) = default;
+    const SpanData& data() const;
+    /// Expansion target for macros (empty if not within a macro)
+    Span outer_span() const;
+    bool is_empty() const { return m_idx == 0; }
 
     void bug(::std::function<void(::std::ostream&)> msg) const;
     void error(ErrorType tag, ::std::function<void(::std::ostream&)> msg) const;
@@ -61,6 +67,38 @@ struct Span
     void note(::std::function<void(::std::ostream&)> msg) const;
 
     friend ::std::ostream& operator<<(::std::ostream& os, const Span& sp);
+
+    /// Get the source map size and how many new spans reused an existing entry
+    static void get_stats(::std::vector< ::std::pair<const char*, size_t> >& out);
+};
+/// Entry in the source map
+struct SpanData
+{
+    RcString    filename;
+    unsigned int start_line;
+    unsigned int start_ofs;
+    unsigned int end_line;
+    unsigned int end_ofs;
+    Span    outer_span;
+};
+
+/// Captures the span messages (errors, warnings and notes) emitted by the current thread, for parallel passes
+///
+/// While active, messages are appended to the passed string instead of being printed, and fatal messages (errors and
+/// bugs) throw `SpanMessageCapture::Fatal` instead of stopping the compiler. This lets the caller print the messages
+/// of each task in a fixed order, stopping at the first fatal one (with `exit_fatal`).
+class SpanMessageCapture
+{
+    ::std::string*  m_saved;
+public:
+    struct Fatal {};
+
+    SpanMessageCapture(::std::string& out);
+    SpanMessageCapture(const SpanMessageCapture&) = delete;
+    ~SpanMessageCapture();
+
+    /// Stop the compiler, as is done after printing a fatal message
+    static void exit_fatal();
 };
 
 template<typename T>
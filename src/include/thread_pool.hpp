@@ -0,0 +1,36 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * include/thread_pool.hpp
+ * - Work-stealing thread pool used to run independent per-item work in parallel
+ */
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+/// Number of threads to use for parallel compiler passes (`-Z threads=N`, 1 means everything runs serially)
+extern unsigned int g_num_threads;
+
+class ThreadPool
+{
+    struct Inner;
+    ::std::unique_ptr<Inner>    m_inner;
+public:
+    /// Create a pool with `num_threads` workers (the calling thread counts as one of them)
+    ThreadPool(unsigned int num_threads = g_num_threads);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    unsigned int num_threads() const;
+
+    /// Call `cb(idx)` for each `idx` in `0 .. count`, returning once all calls have completed
+    /// - The index range is split evenly between workers, idle workers steal from busy ones.
+    /// - With a single worker, calls happen in order on the calling thread.
+    /// - Otherwise, each call runs with the caller's debug state, and its trace output is buffered then written in index order.
+    ///   (A call that hits a fatal error writes its buffer out straight away, see `debug_flush_buffered`)
+    /// - If any call throws, the first exception is re-thrown once all workers have stopped.
+    void for_each_index(size_t count, ::std::function<void(size_t)> cb);
+};
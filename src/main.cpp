@@ -25,10 +25,13 @@
 #include "mir/main_bindings.hpp"
 #include "trans/main_bindings.hpp"
 #include "trans/target.hpp"
+#include "hir_typeck/impl_cache.hpp"
+#include <hir/visitor.hpp>
 
 #include "expand/cfg.hpp"
 #include <target_detect.h>	// tools/common/target_detect.h
 #include <debug_inner.hpp>
+#include <thread_pool.hpp>
 
 TargetVersion	gTargetVersion = TargetVersion::Rustc1_29;
 
@@ -62,6 +65,8 @@ struct ProgramParams
 
     // NOTE: If populated, nothing happens except for loading the target
     ::std::string   target_saveback;
+    // JSON file for per-phase statistics (`--phase-stats`)
+    ::std::string   phase_stats_file;
 
     ::std::vector<const char*> lib_search_dirs;
     ::std::vector<const char*> libraries;
@@ -77,10 +82,16 @@ struct ProgramParams
         bool dump_ast = false;
         bool dump_hir = false;
         bool dump_mir = false;
+
+        unsigned int num_threads = 1;
+        size_t  inline_budget = 0;
+        bool mir_opt_stats = false;
+        ::std::string   mir_cache_dir;
     } debug;
     struct {
         ::std::string   codegen_type;
         ::std::string   emit_build_command;
+        unsigned int    codegen_units = 1;
     } codegen;
 
     ProgramParams(int argc, char *argv[]);
@@ -88,17 +99,71 @@ struct ProgramParams
     void show_help() const;
 };
 
+/// Releases per-phase caches at the end of a phase (`ImplRef`s from the impl caches don't outlive the phase)
+struct PhaseEndCleanup {
+    ~PhaseEndCleanup() {
+        ImplQueryCache::release_retired_all();
+    }
+};
 template <typename Rv, typename Fcn>
 Rv CompilePhase(const char *name, Fcn f) {
     DebugTimedPhase timed_phase(name);
+    PhaseEndCleanup cleanup;
     return f();
 }
 template <typename Fcn>
 void CompilePhaseV(const char *name, Fcn f) {
     DebugTimedPhase timed_phase(name);
+    PhaseEndCleanup cleanup;
     f();
 }
 
+/// Count functions/types/impls in the HIR (for `--phase-stats`)
+void count_hir_items(::HIR::Crate& crate, ::std::vector< ::std::pair<const char*, size_t> >& out)
+{
+    struct Counter: public ::HIR::Visitor
+    {
+        size_t  n_functions = 0;
+        size_t  n_types = 0;
+        size_t  n_traits = 0;
+        size_t  n_impls = 0;
+
+        void visit_function(::HIR::ItemPath p, ::HIR::Function& item) override { n_functions ++; }
+        void visit_type_alias(::HIR::ItemPath p, ::HIR::TypeAlias& item) override { n_types ++; }
+        void visit_struct(::HIR::ItemPath p, ::HIR::Struct& item) override { n_types ++; }
+        void visit_enum(::HIR::ItemPath p, ::HIR::Enum& item) override { n_types ++; }
+        void visit_union(::HIR::ItemPath p, ::HIR::Union& item) override { n_types ++; }
+        void visit_trait(::HIR::ItemPath p, ::HIR::Trait& item) override {
+            n_traits ++;
+            ::HIR::Visitor::visit_trait(p, item);
+        }
+        void visit_type_impl(::HIR::TypeImpl& impl) override {
+            n_impls ++;
+            ::HIR::Visitor::visit_type_impl(impl);
+        }
+        void visit_trait_impl(const ::HIR::SimplePath& trait_path, ::HIR::TraitImpl& impl) override {
+            n_impls ++;
+            ::HIR::Visitor::visit_trait_impl(trait_path, impl);
+        }
+        void visit_marker_impl(const ::HIR::SimplePath& trait_path, ::HIR::MarkerImpl& impl) override { n_impls ++; }
+
+        // Only items are counted, don't walk types/paths/bodies
+        void visit_static(::HIR::ItemPath p, ::HIR::Static& item) override {}
+        void visit_constant(::HIR::ItemPath p, ::HIR::Constant& item) override {}
+        void visit_associatedtype(::HIR::ItemPath p, ::HIR::AssociatedType& item) override {}
+        void visit_params(::HIR::GenericParams& params) override {}
+        void visit_type(::HIR::TypeRef& tr) override {}
+        void visit_trait_path(::HIR::TraitPath& p) override {}
+        void visit_path_params(::HIR::PathParams& p) override {}
+        void visit_expr(::HIR::ExprPtr& exp) override {}
+    } c;
+    c.visit_crate(crate);
+    out.push_back(::std::make_pair("functions", c.n_functions));
+    out.push_back(::std::make_pair("types", c.n_types));
+    out.push_back(::std::make_pair("traits", c.n_traits));
+    out.push_back(::std::make_pair("impls", c.n_impls));
+}
+
 void init_debug_list()
 {
     debug_init_phases("MRUSTC_DEBUG", {
@@ -158,6 +223,28 @@ int main(int argc, char *argv[])
 {
     init_debug_list();
     ProgramParams   params(argc, argv);
+    g_num_threads = params.debug.num_threads;
+    if( params.phase_stats_file != "" )
+    {
+        debug_enable_phase_stats(params.phase_stats_file);
+    }
+    if( params.debug.mir_opt_stats )
+    {
+        MIR_Optimise_EnablePassStats();
+    }
+    if( params.debug.full_validate || getenv("MRUSTC_FULL_VALIDATE") )
+    {
+        // Run the optimisation passes that the scheduler skips, to check that they'd really make no change
+        MIR_Optimise_EnablePassCheck();
+    }
+    if( params.debug.mir_cache_dir != "" )
+    {
+        // Cached entries are the output of Cleanup+Optimise on an external crate's MIR, which depends on the target
+        // (layouts) and the language version (lang items).
+        // - `-O`, `-Z inline-budget` and `-Z disable-mir-opt` are applied outside of that step (codegen, the post-monomorph
+        //   inline pass, and the crate-level optimise of this crate's own MIR) so don't invalidate entries.
+        Trans_Monomorphise_SetMirCache(params.debug.mir_cache_dir, FMT(params.target << " " << static_cast<int>(gTargetVersion)));
+    }
 
     // Set up cfg values
     Cfg_SetValue("rust_compiler", "mrustc");
@@ -439,6 +526,16 @@ int main(int argc, char *argv[])
             });
         // Deallocate the original crate
         crate = ::AST::Crate();
+        // Count HIR items (and layout cache usage) for the phase stats (until the crate is freed)
+        debug_set_phase_item_counter([&](::std::vector< ::std::pair<const char*, size_t> >& out) {
+            count_hir_items(*hir_crate, out);
+            Target_GetLayoutCacheStats(out);
+            ImplQueryCache::get_stats(out);
+            Span::get_stats(out);
+            });
+        struct ItemCounterGuard {
+            ~ItemCounterGuard() { debug_set_phase_item_counter(nullptr); }
+        } item_counter_guard;
         if( params.debug.dump_hir )
         {
             CompilePhaseV("Dump HIR", [&]() {
@@ -598,6 +695,7 @@ int main(int argc, char *argv[])
             });
 
         if( params.last_stage == ProgramParams::STAGE_MIR ) {
+            MIR_Optimise_DumpPassStats(::std::cerr);
             return 0;
         }
 
@@ -609,6 +707,7 @@ int main(int argc, char *argv[])
         trans_opt.mode = params.codegen.codegen_type == "" ? "c" : params.codegen.codegen_type;
         trans_opt.build_command_file = params.codegen.emit_build_command;
         trans_opt.opt_level = params.opt_level;
+        trans_opt.codegen_units = params.codegen.codegen_units;
         for(const char* libdir : params.lib_search_dirs ) {
             // Store these paths for use in final linking.
             hir_crate->m_link_paths.push_back( libdir );
@@ -655,7 +754,7 @@ int main(int argc, char *argv[])
         // - Generate monomorphised versions of all functions
         CompilePhaseV("Trans Monomorph", [&]() { Trans_Monomorphise_List(*hir_crate, items); });
         // - Do post-monomorph inlining
-        CompilePhaseV("MIR Optimise Inline", [&]() { MIR_OptimiseCrate_Inlining(*hir_crate, items); });
+        CompilePhaseV("MIR Optimise Inline", [&]() { MIR_OptimiseCrate_Inlining(*hir_crate, items, params.debug.inline_budget); });
         // - Clean up no-unused functions
         //CompilePhaseV("Trans Enumerate Cleanup", [&]() { Trans_Enumerate_Cleanup(*hir_crate, items); });
 
@@ -690,7 +789,7 @@ int main(int argc, char *argv[])
             TransList items = CompilePhase<TransList>("Trans Enumerate PM", [&]() { return Trans_Enumerate_Main(*hir_crate); });
             CompilePhaseV("Trans Auto Impls PM", [&]() { Trans_AutoImpls(*hir_crate, items); });
             CompilePhaseV("Trans Monomorph PM", [&]() { Trans_Monomorphise_List(*hir_crate, items); });
-            CompilePhaseV("MIR Optimise Inline PM", [&]() { MIR_OptimiseCrate_Inlining(*hir_crate, items); });
+            CompilePhaseV("MIR Optimise Inline PM", [&]() { MIR_OptimiseCrate_Inlining(*hir_crate, items, params.debug.inline_budget); });
             // - Save a very basic HIR dump, making sure that there's no lang items in it (e.g. `mrustc-main`)
             CompilePhaseV("HIR Serialise", [&]() {
                 auto saved_lang_items = ::std::move(hir_crate->m_lang_items); hir_crate->m_lang_items.clear();
@@ -721,6 +820,7 @@ int main(int argc, char *argv[])
     //    return 2;
     //}
 
+    MIR_Optimise_DumpPassStats(::std::cerr);
     return 0;
 }
 
@@ -816,6 +916,14 @@ ProgramParams::ProgramParams(int argc, char *argv[])
                     get_optval();
                     this->emit_depfile = optval;
                 }
+                else if( optname == "codegen-units" ) {
+                    get_optval();
+                    this->codegen.codegen_units = ::std::strtoul(optval.c_str(), nullptr, 10);
+                    if( this->codegen.codegen_units == 0 ) {
+                        ::std::cerr << "Flag -C codegen-units requires a positive integer" << ::std::endl;
+                        exit(1);
+                    }
+                }
                 else {
                     ::std::cerr << "Unknown codegen option: '" << optname << "'" << ::std::endl;
                     exit(1);
@@ -876,6 +984,33 @@ ProgramParams::ProgramParams(int argc, char *argv[])
                     no_optval();
                     this->debug.dump_mir = true;
                 }
+                else if( optname == "threads" ) {
+                    get_optval();
+                    this->debug.num_threads = ::std::strtoul(optval.c_str(), nullptr, 10);
+                    if( this->debug.num_threads == 0 ) {
+                        ::std::cerr << "Flag -Z threads requires a positive integer" << ::std::endl;
+                        exit(1);
+                    }
+                }
+                else if( optname == "mir-opt-stats" ) {
+                    no_optval();
+                    this->debug.mir_opt_stats = true;
+                }
+                else if( optname == "mir-cache" ) {
+                    get_optval();
+                    this->debug.mir_cache_dir = optval;
+                }
+                else if( optname == "hir-container" ) {
+                    get_optval();
+                    if( !HIR_Serialise_SetContainer(optval) ) {
+                        ::std::cerr << "Unknown argument to -Z hir-container - '" << optval << "'" << ::std::endl;
+                        exit(1);
+                    }
+                }
+                else if( optname == "inline-budget" ) {
+                    get_optval();
+                    this->debug.inline_budget = ::std::strtoul(optval.c_str(), nullptr, 10);
+                }
                 else if( optname == "stop-after" ) {
                     get_optval();
                     if( optval == "parse" )
@@ -1071,6 +1206,17 @@ ProgramParams::ProgramParams(int argc, char *argv[])
             else if( strcmp(arg, "--test") == 0 ) {
                 this->test_harness = true;
             }
+            // --phase-stats <file> >> Write per-phase timing/memory/item statistics (JSON) to a file
+            else if( strcmp(arg, "--phase-stats") == 0 ) {
+                if (i == argc - 1) {
+                    ::std::cerr << "Flag " << arg << " requires an argument" << ::std::endl;
+                    exit(1);
+                }
+                this->phase_stats_file = argv[++i];
+            }
+            else if( strncmp(arg, "--phase-stats=", 14) == 0 ) {
+                this->phase_stats_file = arg + 14;
+            }
             else {
                 ::std::cerr << "Unknown option '" << arg << "'" << ::std::endl;
                 exit(1);
@@ -1147,6 +1293,8 @@ void ProgramParams::show_help() const
         "--cfg flag=\"val\"   : Set a string #[cfg]/cfg! flag\n"
         "--target <name>    : Compile code for the given target\n"
         "--test             : Generate a unit test executable\n"
+        "--phase-stats <file>\n"
+        "                   : Write per-phase statistics (time, memory, allocations, item counts) as JSON\n"
         "-C <option>        : Code-generation options\n"
         "-Z <option>        : Debugging/experiemental options\n"
         ;
@@ -985,6 +985,6 @@ void MIR_CheckCrate_Full(/*const*/ ::HIR::Crate& crate)
             MIR_Validate_Full(res, p, *expr.m_mir, args, ty);
         }
         );
-    ov.visit_crate( crate );
+    ov.visit_crate_parallel( crate );
 }
 
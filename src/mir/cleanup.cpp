@@ -1267,6 +1267,6 @@ void MIR_CleanupCrate(::HIR::Crate& crate)
     ::MIR::OuterVisitor    ov { crate, [&](const auto& res, const auto& p, ::HIR::ExprPtr& expr_ptr, const auto& args, const auto& ty){
             MIR_Cleanup(res, p, expr_ptr.get_mir_or_error_mut(Span()), args, ty);
         } };
-    ov.visit_crate(crate);
+    ov.visit_crate_parallel(crate);
 }
 
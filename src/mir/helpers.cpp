@@ -11,6 +11,7 @@
 #include <hir/type.hpp>
 #include <mir/mir.hpp>
 #include <algorithm>    // ::std::find
+#include <atomic>
 
 void ::MIR::TypeResolve::fmt_pos(::std::ostream& os, bool include_path/*=false*/) const
 {
@@ -392,203 +393,6 @@ using namespace MIR::visit;
 // --------------------------------------------------------------------
 // MIR_Helper_GetLifetimes
 // --------------------------------------------------------------------
-namespace MIR {
-namespace visit {
-    bool visit_mir_lvalue(const ::MIR::LValue& lv, ValUsage u, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
-    {
-        if( cb(lv, u) )
-            return true;
-#if 1
-        for(const auto& w : lv.m_wrappers)
-        {
-            if( w.is_Index() )
-            {
-                cb(LValue::new_Local(w.as_Index()), ValUsage::Read);
-            }
-        }
-#else
-        TU_MATCHA( (lv), (e),
-        (Return,
-            ),
-        (Argument,
-            ),
-        (Local,
-            ),
-        (Static,
-            ),
-        (Field,
-            return visit_mir_lvalue(*e.val, u, cb);
-            ),
-        (Deref,
-            return visit_mir_lvalue(*e.val, ValUsage::Read, cb);
-            ),
-        (Index,
-            bool rv = false;
-            rv |= visit_mir_lvalue(*e.val, u, cb);
-            rv |= visit_mir_lvalue(*e.idx, ValUsage::Read, cb);
-            return rv;
-            ),
-        (Downcast,
-            return visit_mir_lvalue(*e.val, u, cb);
-            )
-        )
-#endif
-        return false;
-    }
-
-    bool visit_mir_lvalue(const ::MIR::Param& p, ValUsage u, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
-    {
-        if( const auto* e = p.opt_LValue() )
-        {
-            if(cb(*e, ValUsage::Move))
-                return true;
-            return visit_mir_lvalue(*e, u, cb);
-        }
-        else
-        {
-            return false;
-        }
-    }
-
-    bool visit_mir_lvalues(const ::MIR::RValue& rval, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
-    {
-        bool rv = false;
-        TU_MATCHA( (rval), (se),
-        (Use,
-            if(cb(se, ValUsage::Move))
-                return true;
-            rv |= visit_mir_lvalue(se, ValUsage::Read, cb);
-            ),
-        (Constant,
-            ),
-        (SizedArray,
-            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
-            ),
-        (Borrow,
-            rv |= visit_mir_lvalue(se.val, ValUsage::Borrow, cb);
-            ),
-        (Cast,
-            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
-            ),
-        (BinOp,
-            rv |= visit_mir_lvalue(se.val_l, ValUsage::Read, cb);
-            rv |= visit_mir_lvalue(se.val_r, ValUsage::Read, cb);
-            ),
-        (UniOp,
-            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
-            ),
-        (DstMeta,
-            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
-            ),
-        (DstPtr,
-            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
-            ),
-        (MakeDst,
-            rv |= visit_mir_lvalue(se.ptr_val, ValUsage::Read, cb);
-            rv |= visit_mir_lvalue(se.meta_val, ValUsage::Read, cb);
-            ),
-        (Tuple,
-            for(auto& v : se.vals)
-                rv |= visit_mir_lvalue(v, ValUsage::Read, cb);
-            ),
-        (Array,
-            for(auto& v : se.vals)
-                rv |= visit_mir_lvalue(v, ValUsage::Read, cb);
-            ),
-        (Variant,
-            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
-            ),
-        (Struct,
-            for(auto& v : se.vals)
-                rv |= visit_mir_lvalue(v, ValUsage::Read, cb);
-            )
-        )
-        return rv;
-    }
-
-    bool visit_mir_lvalues(const ::MIR::Statement& stmt, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
-    {
-        bool rv = false;
-        TU_MATCHA( (stmt), (e),
-        (Assign,
-            rv |= visit_mir_lvalues(e.src, cb);
-            rv |= visit_mir_lvalue(e.dst, ValUsage::Write, cb);
-            ),
-        (Asm,
-            for(auto& v : e.inputs)
-                rv |= visit_mir_lvalue(v.second, ValUsage::Read, cb);
-            for(auto& v : e.outputs)
-                rv |= visit_mir_lvalue(v.second, ValUsage::Write, cb);
-            ),
-        (SetDropFlag,
-            ),
-        (Drop,
-            rv |= visit_mir_lvalue(e.slot, ValUsage::Move, cb);
-            ),
-        (ScopeEnd,
-            )
-        )
-        return rv;
-    }
-
-    bool visit_mir_lvalues(const ::MIR::Terminator& term, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
-    {
-        bool rv = false;
-        TU_MATCHA( (term), (e),
-        (Incomplete,
-            ),
-        (Return,
-            ),
-        (Diverge,
-            ),
-        (Goto,
-            ),
-        (Panic,
-            ),
-        (If,
-            rv |= visit_mir_lvalue(e.cond, ValUsage::Read, cb);
-            ),
-        (Switch,
-            rv |= visit_mir_lvalue(e.val, ValUsage::Read, cb);
-            ),
-        (SwitchValue,
-            rv |= visit_mir_lvalue(e.val, ValUsage::Read, cb);
-            ),
-        (Call,
-            if( e.fcn.is_Value() ) {
-                rv |= visit_mir_lvalue(e.fcn.as_Value(), ValUsage::Read, cb);
-            }
-            for(auto& v : e.args)
-                rv |= visit_mir_lvalue(v, ValUsage::Read, cb);
-            rv |= visit_mir_lvalue(e.ret_val, ValUsage::Write, cb);
-            )
-        )
-        return rv;
-    }
-    /*
-    void visit_mir_lvalues_mut(::MIR::TypeResolve& state, ::MIR::Function& fcn, ::std::function<bool(::MIR::LValue& , ValUsage)> cb)
-    {
-        for(unsigned int block_idx = 0; block_idx < fcn.blocks.size(); block_idx ++)
-        {
-            auto& block = fcn.blocks[block_idx];
-            for(auto& stmt : block.statements)
-            {
-                state.set_cur_stmt(block_idx, (&stmt - &block.statements.front()));
-                visit_mir_lvalues_mut(stmt, cb);
-            }
-            if( block.terminator.tag() == ::MIR::Terminator::TAGDEAD )
-                continue ;
-            state.set_cur_stmt_term(block_idx);
-            visit_mir_lvalues_mut(block.terminator, cb);
-        }
-    }
-    void visit_mir_lvalues(::MIR::TypeResolve& state, const ::MIR::Function& fcn, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
-    {
-        visit_mir_lvalues_mut(state, const_cast<::MIR::Function&>(fcn), [&](auto& lv, auto im){ return cb(lv, im); });
-    }
-    */
-}   // namespace visit
-}   // namespace MIR
 namespace
 {
     struct ValueLifetime
@@ -1236,7 +1040,7 @@ void MIR_Helper_GetLifetimes_DetermineValueLifetime(
             return this->end == Position { ~0u, ~0u };
         }
     };
-    static unsigned NEXT_INDEX = 0;
+    static ::std::atomic<unsigned> NEXT_INDEX { 0 };
     struct State
     {
         unsigned int index = 0;
@@ -198,11 +198,158 @@ namespace visit {
         Borrow,
     };
 
-    extern bool visit_mir_lvalue(const ::MIR::LValue& lv, ValUsage u, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb);
-    extern bool visit_mir_lvalue(const ::MIR::Param& p, ValUsage u, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb);
-    extern bool visit_mir_lvalues(const ::MIR::RValue& rval, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb);
-    extern bool visit_mir_lvalues(const ::MIR::Statement& stmt, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb);
-    extern bool visit_mir_lvalues(const ::MIR::Terminator& term, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb);
+    // NOTE: These are templates (instead of taking `std::function`) so the callback can be inlined, they're called for
+    // every lvalue in a function.
+    // - Callbacks are `bool(const ::MIR::LValue&, ValUsage)`, returning true stops the visit.
+
+    template<typename Cb>
+    bool visit_mir_lvalue(const ::MIR::LValue& lv, ValUsage u, Cb&& cb)
+    {
+        if( cb(lv, u) )
+            return true;
+        for(const auto& w : lv.m_wrappers)
+        {
+            if( w.is_Index() )
+            {
+                cb(::MIR::LValue::new_Local(w.as_Index()), ValUsage::Read);
+            }
+        }
+        return false;
+    }
+
+    template<typename Cb>
+    bool visit_mir_lvalue(const ::MIR::Param& p, ValUsage u, Cb&& cb)
+    {
+        if( const auto* e = p.opt_LValue() )
+        {
+            if(cb(*e, ValUsage::Move))
+                return true;
+            return visit_mir_lvalue(*e, u, cb);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    template<typename Cb>
+    bool visit_mir_lvalues(const ::MIR::RValue& rval, Cb&& cb)
+    {
+        bool rv = false;
+        TU_MATCHA( (rval), (se),
+        (Use,
+            if(cb(se, ValUsage::Move))
+                return true;
+            rv |= visit_mir_lvalue(se, ValUsage::Read, cb);
+            ),
+        (Constant,
+            ),
+        (SizedArray,
+            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
+            ),
+        (Borrow,
+            rv |= visit_mir_lvalue(se.val, ValUsage::Borrow, cb);
+            ),
+        (Cast,
+            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
+            ),
+        (BinOp,
+            rv |= visit_mir_lvalue(se.val_l, ValUsage::Read, cb);
+            rv |= visit_mir_lvalue(se.val_r, ValUsage::Read, cb);
+            ),
+        (UniOp,
+            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
+            ),
+        (DstMeta,
+            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
+            ),
+        (DstPtr,
+            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
+            ),
+        (MakeDst,
+            rv |= visit_mir_lvalue(se.ptr_val, ValUsage::Read, cb);
+            rv |= visit_mir_lvalue(se.meta_val, ValUsage::Read, cb);
+            ),
+        (Tuple,
+            for(auto& v : se.vals)
+                rv |= visit_mir_lvalue(v, ValUsage::Read, cb);
+            ),
+        (Array,
+            for(auto& v : se.vals)
+                rv |= visit_mir_lvalue(v, ValUsage::Read, cb);
+            ),
+        (Variant,
+            rv |= visit_mir_lvalue(se.val, ValUsage::Read, cb);
+            ),
+        (Struct,
+            for(auto& v : se.vals)
+                rv |= visit_mir_lvalue(v, ValUsage::Read, cb);
+            )
+        )
+        return rv;
+    }
+
+    template<typename Cb>
+    bool visit_mir_lvalues(const ::MIR::Statement& stmt, Cb&& cb)
+    {
+        bool rv = false;
+        TU_MATCHA( (stmt), (e),
+        (Assign,
+            rv |= visit_mir_lvalues(e.src, cb);
+            rv |= visit_mir_lvalue(e.dst, ValUsage::Write, cb);
+            ),
+        (Asm,
+            for(auto& v : e.inputs)
+                rv |= visit_mir_lvalue(v.second, ValUsage::Read, cb);
+            for(auto& v : e.outputs)
+                rv |= visit_mir_lvalue(v.second, ValUsage::Write, cb);
+            ),
+        (SetDropFlag,
+            ),
+        (Drop,
+            rv |= visit_mir_lvalue(e.slot, ValUsage::Move, cb);
+            ),
+        (ScopeEnd,
+            )
+        )
+        return rv;
+    }
+
+    template<typename Cb>
+    bool visit_mir_lvalues(const ::MIR::Terminator& term, Cb&& cb)
+    {
+        bool rv = false;
+        TU_MATCHA( (term), (e),
+        (Incomplete,
+            ),
+        (Return,
+            ),
+        (Diverge,
+            ),
+        (Goto,
+            ),
+        (Panic,
+            ),
+        (If,
+            rv |= visit_mir_lvalue(e.cond, ValUsage::Read, cb);
+            ),
+        (Switch,
+            rv |= visit_mir_lvalue(e.val, ValUsage::Read, cb);
+            ),
+        (SwitchValue,
+            rv |= visit_mir_lvalue(e.val, ValUsage::Read, cb);
+            ),
+        (Call,
+            if( e.fcn.is_Value() ) {
+                rv |= visit_mir_lvalue(e.fcn.as_Value(), ValUsage::Read, cb);
+            }
+            for(auto& v : e.args)
+                rv |= visit_mir_lvalue(v, ValUsage::Read, cb);
+            rv |= visit_mir_lvalue(e.ret_val, ValUsage::Write, cb);
+            )
+        )
+        return rv;
+    }
 }   // namespace visit
 
 }   // namespace MIR
@@ -3,17 +3,63 @@
  * - By John Hodge (Mutabah/thePowersGang)
  *
  * mir/mir_ptr.cpp
- * - Destructor for MIR function pointers (cold path code)
+ * - Destructor and deferred loading for MIR function pointers (cold path code)
  */
 #include "mir_ptr.hpp"
 #include "mir.hpp"
-
+#include <mutex>
 
 void ::MIR::FunctionPointer::reset()
 {
-    if( this->ptr ) {
-        delete this->ptr;
+    if( auto* p = this->ptr.load() ) {
+        delete p;
         this->ptr = nullptr;
     }
+    if( this->loader ) {
+        delete this->loader;
+        this->loader = nullptr;
+    }
 }
 
+::MIR::Function* ::MIR::FunctionPointer::load_slow() const
+{
+    if( !this->loader )
+        throw "";
+    auto& l = *this->loader;
+    // No lock is held while loading or running the fixups, as they can load other functions
+    ::std::call_once(l.m_once, [&]() {
+        auto* fcn = l.load();
+        // Run fixups until none are left (more can be registered by other threads until the pointer is published)
+        for(;;)
+        {
+            ::std::vector< ::std::function<void(::MIR::Function&)> > cbs;
+            {
+                ::std::lock_guard< ::std::mutex>    lh { l.m_lock };
+                if( l.m_on_load.empty() ) {
+                    this->ptr.store(fcn, ::std::memory_order_release);
+                    break;
+                }
+                cbs = ::std::move(l.m_on_load);
+                l.m_on_load.clear();
+            }
+            for(auto& cb : cbs)
+                cb(*fcn);
+        }
+        });
+    return this->ptr.load(::std::memory_order_acquire);
+}
+void ::MIR::FunctionPointer::on_load(::std::function<void(::MIR::Function&)> cb)
+{
+    if( !this->ptr.load(::std::memory_order_acquire) )
+    {
+        if( !this->loader )
+            throw "";
+        ::std::lock_guard< ::std::mutex>    lh { this->loader->m_lock };
+        if( !this->ptr.load(::std::memory_order_relaxed) )
+        {
+            this->loader->m_on_load.push_back( ::std::move(cb) );
+            return ;
+        }
+    }
+    cb(**this);
+}
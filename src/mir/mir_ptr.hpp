@@ -6,37 +6,76 @@
  * - Pointer to a blob of MIR
  */
 #pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
 
 namespace MIR {
 
 class Function;
 
+/// Source for a MIR function that is only materialised when first needed (e.g. an undecoded body in crate metadata)
+class FunctionLoader
+{
+    friend class FunctionPointer;
+    // Each function is loaded separately, so a fixup can load other functions (e.g. binding paths in an inlined body)
+    ::std::once_flag    m_once;
+    // Protects `m_on_load`, and the switch from pending to loaded
+    ::std::mutex    m_lock;
+    /// Fixups to apply once the function is loaded (e.g. binding paths)
+    ::std::vector< ::std::function<void(::MIR::Function&)> >   m_on_load;
+public:
+    virtual ~FunctionLoader() {}
+    /// Decode the function (called at most once - should release any source data once done)
+    virtual ::MIR::Function* load() = 0;
+};
+
 class FunctionPointer
 {
-    ::MIR::Function*    ptr;
+    mutable ::std::atomic< ::MIR::Function*>    ptr;
+    ::MIR::FunctionLoader*  loader;
 public:
-    FunctionPointer(): ptr(nullptr) {}
-    FunctionPointer(::MIR::Function* p): ptr(p) {}
-    FunctionPointer(FunctionPointer&& x): ptr(x.ptr) { x.ptr = nullptr; }
+    FunctionPointer(): ptr(nullptr), loader(nullptr) {}
+    FunctionPointer(::MIR::Function* p): ptr(p), loader(nullptr) {}
+    FunctionPointer(::MIR::FunctionLoader* l): ptr(nullptr), loader(l) {}
+    FunctionPointer(FunctionPointer&& x): ptr(x.ptr.load()), loader(x.loader) { x.ptr = nullptr; x.loader = nullptr; }
 
     ~FunctionPointer() {
         reset();
     }
     FunctionPointer& operator=(FunctionPointer&& x) {
         reset();
-        ptr = x.ptr;
+        ptr = x.ptr.load();
+        loader = x.loader;
         x.ptr = nullptr;
+        x.loader = nullptr;
         return *this;
     }
 
     void reset();
 
-          ::MIR::Function* operator->()       { if(!ptr) throw ""; return ptr; }
-    const ::MIR::Function* operator->() const { if(!ptr) throw ""; return ptr; }
-          ::MIR::Function& operator*()       { if(!ptr) throw ""; return *ptr; }
-    const ::MIR::Function& operator*() const { if(!ptr) throw ""; return *ptr; }
+    /// Run `cb` on the function once it has been loaded (immediately if it's already available)
+    void on_load(::std::function<void(::MIR::Function&)> cb);
 
-    operator bool() const { return ptr != nullptr; }
+          ::MIR::Function* operator->()       { return &get(); }
+    const ::MIR::Function* operator->() const { return &get(); }
+          ::MIR::Function& operator*()       { return get(); }
+    const ::MIR::Function& operator*() const { return get(); }
+
+    /// True if there's a function, even if it hasn't been loaded yet
+    operator bool() const { return ptr.load(::std::memory_order_relaxed) != nullptr || loader != nullptr; }
+    /// True if the function is only available via a (not yet invoked) loader
+    bool is_pending() const { return ptr.load(::std::memory_order_acquire) == nullptr && loader != nullptr; }
+
+private:
+    ::MIR::Function& get() const {
+        auto* rv = ptr.load(::std::memory_order_acquire);
+        if( !rv )
+            rv = load_slow();
+        return *rv;
+    }
+    ::MIR::Function* load_slow() const;
 };
 
 }
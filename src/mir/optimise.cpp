@@ -13,7 +13,12 @@
 #include <mir/helpers.hpp>
 #include <mir/operations.hpp>
 #include <mir/visit_crate_mir.hpp>
+#include <thread_pool.hpp>   // g_num_threads
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <deque>
 #include <iomanip>
 #include <trans/target.hpp>
 #include <trans/trans_list.hpp> // Note: This is included for inlining after enumeration and monomorph
@@ -62,7 +67,7 @@ void MIR_OptimiseMin(const StaticTraitResolve& resolve, const ::HIR::ItemPath& p
     while( MIR_Optimise_Inlining(state, fcn, true) )
     {
         MIR_Cleanup(resolve, path, fcn, args, ret_type);
-        //MIR_Dump_Fcn(::std::cout, fcn);
+        //MIR_Dump_Fcn(debug_stream(), fcn);
         #if CHECK_AFTER_ALL
         MIR_Validate(resolve, path, fcn, args, ret_type);
         #endif
@@ -83,16 +88,29 @@ void MIR_OptimiseMin(const StaticTraitResolve& resolve, const ::HIR::ItemPath& p
     return ;
 }
 /// Perfom inlining only, using a list of monomorphised functions, then cleans up the flow graph
+/// - Stops inlining once the function has more than `size_budget` statements (0 = unlimited)
 ///
 /// Returns true if any optimisation was performed
-bool MIR_OptimiseInline(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path, ::MIR::Function& fcn, const ::HIR::Function::args_t& args, const ::HIR::TypeRef& ret_type, const TransList& list)
+bool MIR_OptimiseInline(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path, ::MIR::Function& fcn, const ::HIR::Function::args_t& args, const ::HIR::TypeRef& ret_type, const TransList& list, size_t size_budget)
 {
     static Span sp;
     bool rv = false;
     TRACE_FUNCTION_FR(path, rv);
     ::MIR::TypeResolve   state { sp, resolve, FMT_CB(ss, ss << path;), ret_type, args, fcn };
 
-    while( MIR_Optimise_Inlining(state, fcn, false, &list) )
+    auto within_budget = [&]()->bool {
+        if( size_budget == 0 )
+            return true;
+        size_t  size = 0;
+        for(const auto& bb : fcn.blocks)
+            size += bb.statements.size() + 1;
+        if( size > size_budget ) {
+            DEBUG("Inlining budget exceeded (" << size << " > " << size_budget << ")");
+            return false;
+        }
+        return true;
+        };
+    while( within_budget() && MIR_Optimise_Inlining(state, fcn, false, &list) )
     {
         MIR_Cleanup(resolve, path, fcn, args, ret_type);
 #if CHECK_AFTER_ALL
@@ -134,12 +152,417 @@ bool MIR_OptimiseInline(const StaticTraitResolve& resolve, const ::HIR::ItemPath
 
     return rv;
 }
+namespace {
+    // Passes run by the fixed-point loop in `MIR_Optimise`
+    enum class OptPass {
+        BlockSimplify,
+        ConstPropagate,
+        DeTemporary,
+        SplitAggregates,
+        PropagateKnownValues,
+        PropagateSingleAssignments,
+        UnifyBlocks,
+        DeadDropFlags,
+        DeadAssignments,
+        NoopRemoval,
+        Inlining,
+        GarbageCollectPartial,
+        COUNT
+    };
+    struct OptPassInfo {
+        const char* name;
+        /// The callback loops until the pass stops making changes (so is clean afterwards)
+        bool    runs_to_fixpoint;
+    };
+    const OptPassInfo OPT_PASSES[] = {
+        { "BlockSimplify", false },
+        { "ConstPropagate", false },
+        { "DeTemporary", true },
+        { "SplitAggregates", false },
+        { "PropagateKnownValues", false },
+        { "PropagateSingleAssignments", true },
+        { "UnifyBlocks", false },
+        { "DeadDropFlags", false },
+        { "DeadAssignments", false },
+        { "NoopRemoval", false },
+        { "Inlining", false },
+        { "GarbageCollect_Partial", false },
+        };
+    static_assert(sizeof(OPT_PASSES)/sizeof(OPT_PASSES[0]) == static_cast<size_t>(OptPass::COUNT), "OPT_PASSES out of sync");
+
+    // Per-pass counters (`-Z mir-opt-stats`), shared between threads
+    struct OptPassStats {
+        ::std::atomic<unsigned long>    runs { 0 };
+        ::std::atomic<unsigned long>    skips { 0 };
+        ::std::atomic<unsigned long>    changes { 0 };
+        ::std::atomic<unsigned long long>   time_ns { 0 };
+    };
+    bool    g_opt_pass_stats_enabled = false;
+    OptPassStats    g_opt_pass_stats[static_cast<size_t>(OptPass::COUNT)];
+
+    bool    g_opt_pass_check = false;
+
+    /// Hash of the full content of a function (locals, drop flags, statements and terminators)
+    class FunctionFingerprint
+    {
+        size_t  m_hash = 0;
+    public:
+        FunctionFingerprint(const ::MIR::Function& fcn)
+        {
+            mix(fcn.locals.size());
+            mix(fcn.drop_flags.size());
+            for(bool v : fcn.drop_flags)
+                mix(v);
+            mix(fcn.blocks.size());
+            for(const auto& bb : fcn.blocks)
+            {
+                mix(bb.statements.size());
+                for(const auto& stmt : bb.statements)
+                    mix_stmt(stmt);
+                mix_term(bb.terminator);
+            }
+        }
+        size_t value() const { return m_hash; }
+
+    private:
+        void mix(size_t v) {
+            m_hash = hash_combine(m_hash, v);
+        }
+        void mix_str(const ::std::string& v) {
+            mix(::std::hash< ::std::string>()(v));
+        }
+        void mix_lv(const ::MIR::LValue& lv) {
+            mix(static_cast<size_t>(lv.m_root.tag()));
+            if( lv.m_root.is_Static() )
+                mix(lv.m_root.as_Static().hash());
+            else
+                mix(lv.m_root.get_inner());
+            mix(lv.m_wrappers.size());
+            for(const auto& w : lv.m_wrappers)
+                mix(w.get_inner());
+        }
+        void mix_const(const ::MIR::Constant& c) {
+            mix(static_cast<size_t>(c.tag()));
+            TU_MATCH_HDRA( (c), {)
+            TU_ARMA(Int, ce) {
+                mix(static_cast<size_t>(ce.v));
+                mix(static_cast<size_t>(ce.t));
+                }
+            TU_ARMA(Uint, ce) {
+                mix(static_cast<size_t>(ce.v));
+                mix(static_cast<size_t>(ce.t));
+                }
+            TU_ARMA(Float, ce) {
+                mix(::std::hash<double>()(ce.v));
+                mix(static_cast<size_t>(ce.t));
+                }
+            TU_ARMA(Bool, ce) {
+                mix(ce.v);
+                }
+            TU_ARMA(Bytes, ce) {
+                mix(ce.size());
+                for(auto b : ce)
+                    mix(b);
+                }
+            TU_ARMA(StaticString, ce) {
+                mix_str(ce);
+                }
+            TU_ARMA(Const, ce) {
+                mix(ce.p->hash());
+                }
+            TU_ARMA(ItemAddr, ce) {
+                mix(ce->hash());
+                }
+            }
+        }
+        void mix_param(const ::MIR::Param& p) {
+            mix(static_cast<size_t>(p.tag()));
+            TU_MATCH_HDRA( (p), {)
+            TU_ARMA(LValue, pe) {
+                mix_lv(pe);
+                }
+            TU_ARMA(Constant, pe) {
+                mix_const(pe);
+                }
+            }
+        }
+        void mix_params(const ::std::vector< ::MIR::Param>& vals) {
+            mix(vals.size());
+            for(const auto& v : vals)
+                mix_param(v);
+        }
+        void mix_rval(const ::MIR::RValue& rv) {
+            mix(static_cast<size_t>(rv.tag()));
+            TU_MATCH_HDRA( (rv), {)
+            TU_ARMA(Use, re) {
+                mix_lv(re);
+                }
+            TU_ARMA(Constant, re) {
+                mix_const(re);
+                }
+            TU_ARMA(SizedArray, re) {
+                mix_param(re.val);
+                mix(re.count);
+                }
+            TU_ARMA(Borrow, re) {
+                mix(static_cast<size_t>(re.type));
+                mix_lv(re.val);
+                }
+            TU_ARMA(Cast, re) {
+                mix_lv(re.val);
+                mix(re.type.hash());
+                }
+            TU_ARMA(BinOp, re) {
+                mix_param(re.val_l);
+                mix(static_cast<size_t>(re.op));
+                mix_param(re.val_r);
+                }
+            TU_ARMA(UniOp, re) {
+                mix_lv(re.val);
+                mix(static_cast<size_t>(re.op));
+                }
+            TU_ARMA(DstMeta, re) {
+                mix_lv(re.val);
+                }
+            TU_ARMA(DstPtr, re) {
+                mix_lv(re.val);
+                }
+            TU_ARMA(MakeDst, re) {
+                mix_param(re.ptr_val);
+                mix_param(re.meta_val);
+                }
+            TU_ARMA(Tuple, re) {
+                mix_params(re.vals);
+                }
+            TU_ARMA(Array, re) {
+                mix_params(re.vals);
+                }
+            TU_ARMA(Variant, re) {
+                mix(re.path.hash());
+                mix(re.index);
+                mix_param(re.val);
+                }
+            TU_ARMA(Struct, re) {
+                mix(re.path.hash());
+                mix_params(re.vals);
+                }
+            }
+        }
+        void mix_stmt(const ::MIR::Statement& stmt) {
+            mix(static_cast<size_t>(stmt.tag()));
+            TU_MATCH_HDRA( (stmt), {)
+            TU_ARMA(Assign, se) {
+                mix_lv(se.dst);
+                mix_rval(se.src);
+                }
+            TU_ARMA(Asm, se) {
+                mix_str(se.tpl);
+                for(const auto& v : se.outputs) {
+                    mix_str(v.first);
+                    mix_lv(v.second);
+                }
+                for(const auto& v : se.inputs) {
+                    mix_str(v.first);
+                    mix_lv(v.second);
+                }
+                for(const auto& v : se.clobbers)
+                    mix_str(v);
+                for(const auto& v : se.flags)
+                    mix_str(v);
+                }
+            TU_ARMA(SetDropFlag, se) {
+                mix(se.idx);
+                mix(se.new_val);
+                mix(se.other);
+                }
+            TU_ARMA(Drop, se) {
+                mix(static_cast<size_t>(se.kind));
+                mix_lv(se.slot);
+                mix(se.flag_idx);
+                }
+            TU_ARMA(ScopeEnd, se) {
+                mix(se.slots.size());
+                for(auto v : se.slots)
+                    mix(v);
+                }
+            }
+        }
+        void mix_term(const ::MIR::Terminator& term) {
+            mix(static_cast<size_t>(term.tag()));
+            TU_MATCH_HDRA( (term), {)
+            TU_ARMA(Incomplete, te) {
+                }
+            TU_ARMA(Return, te) {
+                }
+            TU_ARMA(Diverge, te) {
+                }
+            TU_ARMA(Goto, te) {
+                mix(te);
+                }
+            TU_ARMA(Panic, te) {
+                mix(te.dst);
+                }
+            TU_ARMA(If, te) {
+                mix_lv(te.cond);
+                mix(te.bb0);
+                mix(te.bb1);
+                }
+            TU_ARMA(Switch, te) {
+                mix_lv(te.val);
+                mix(te.targets.size());
+                for(auto v : te.targets)
+                    mix(v);
+                }
+            TU_ARMA(SwitchValue, te) {
+                mix_lv(te.val);
+                mix(te.def_target);
+                mix(te.targets.size());
+                for(auto v : te.targets)
+                    mix(v);
+                mix(static_cast<size_t>(te.values.tag()));
+                TU_MATCH_HDRA( (te.values), {)
+                TU_ARMA(Unsigned, vals) {
+                    for(auto v : vals)
+                        mix(static_cast<size_t>(v));
+                    }
+                TU_ARMA(Signed, vals) {
+                    for(auto v : vals)
+                        mix(static_cast<size_t>(v));
+                    }
+                TU_ARMA(String, vals) {
+                    for(const auto& v : vals)
+                        mix_str(v);
+                    }
+                }
+                }
+            TU_ARMA(Call, te) {
+                mix(te.ret_block);
+                mix(te.panic_block);
+                mix_lv(te.ret_val);
+                mix(static_cast<size_t>(te.fcn.tag()));
+                TU_MATCH_HDRA( (te.fcn), {)
+                TU_ARMA(Value, fe) {
+                    mix_lv(fe);
+                    }
+                TU_ARMA(Path, fe) {
+                    mix(fe.hash());
+                    }
+                TU_ARMA(Intrinsic, fe) {
+                    mix(::std::hash<RcString>()(fe.name));
+                    mix(fe.params.hash());
+                    }
+                }
+                mix_params(te.args);
+                }
+            }
+        }
+    };
+
+    /// Scheduler for the fixed-point optimisation loop
+    ///
+    /// The function's content fingerprint is taken after every pass, and each change (reported by the pass or not)
+    /// bumps its generation. A pass that last ran without making a change at the current generation would see exactly
+    /// the same input, so is skipped instead of rescanning the function.
+    /// - The function must only be modified by passes run through `run`
+    /// - With `-Z full-validate`, skipped passes are run anyway and it's a bug if they change the function.
+    class OptPassScheduler
+    {
+        ::MIR::TypeResolve& m_state;
+        const ::MIR::Function&  m_fcn;
+        unsigned    m_generation = 1;
+        size_t  m_fingerprint;
+        unsigned    m_clean_at[static_cast<size_t>(OptPass::COUNT)] = {};  // 0 = never ran clean
+    public:
+        OptPassScheduler(::MIR::TypeResolve& state, const ::MIR::Function& fcn):
+            m_state(state),
+            m_fcn(fcn),
+            m_fingerprint(FunctionFingerprint(fcn).value())
+        {
+        }
+
+        /// Run `cb` (returns true if it changed the function) unless the function is unchanged since it last ran clean
+        template<typename Cb>
+        bool run(OptPass pass, Cb cb)
+        {
+            auto idx = static_cast<size_t>(pass);
+            auto& stats = g_opt_pass_stats[idx];
+            if( m_clean_at[idx] == m_generation )
+            {
+                DEBUG("Skip " << OPT_PASSES[idx].name << " (unchanged since last run)");
+                if( g_opt_pass_stats_enabled )
+                    stats.skips += 1;
+                if( g_opt_pass_check )
+                {
+                    if( cb() || FunctionFingerprint(m_fcn).value() != m_fingerprint )
+                        MIR_BUG(m_state, "Skipped pass " << OPT_PASSES[idx].name << " changed the function");
+                }
+                return false;
+            }
+
+            bool rv;
+            if( g_opt_pass_stats_enabled )
+            {
+                auto start = ::std::chrono::steady_clock::now();
+                rv = cb();
+                auto dur = ::std::chrono::steady_clock::now() - start;
+                stats.time_ns += ::std::chrono::duration_cast< ::std::chrono::nanoseconds>(dur).count();
+                stats.runs += 1;
+                if( rv )
+                    stats.changes += 1;
+            }
+            else
+            {
+                rv = cb();
+            }
+
+            // Some passes make minor changes without reporting them (e.g. removing write-only locals), so compare the
+            // content instead of trusting the return value.
+            auto fp = FunctionFingerprint(m_fcn).value();
+            bool changed = rv || fp != m_fingerprint;
+            if( changed )
+            {
+                m_fingerprint = fp;
+                m_generation += 1;
+            }
+            // Clean if it made no change, or if it loops until it stops making changes
+            if( !changed || (rv && OPT_PASSES[idx].runs_to_fixpoint) )
+                m_clean_at[idx] = m_generation;
+            return rv;
+        }
+    };
+}
+
+void MIR_Optimise_EnablePassStats()
+{
+    g_opt_pass_stats_enabled = true;
+}
+void MIR_Optimise_EnablePassCheck()
+{
+    g_opt_pass_check = true;
+}
+void MIR_Optimise_DumpPassStats(::std::ostream& os)
+{
+    if( !g_opt_pass_stats_enabled )
+        return ;
+    os << "MIR optimisation pass statistics:" << ::std::endl;
+    os << "  " << ::std::left << ::std::setw(28) << "Pass" << ::std::right
+        << ::std::setw(10) << "Runs" << ::std::setw(10) << "Skips" << ::std::setw(10) << "Changes" << ::std::setw(12) << "Time (s)" << ::std::endl;
+    for(size_t i = 0; i < static_cast<size_t>(OptPass::COUNT); i ++)
+    {
+        const auto& stats = g_opt_pass_stats[i];
+        os << "  " << ::std::left << ::std::setw(28) << OPT_PASSES[i].name << ::std::right
+            << ::std::setw(10) << stats.runs << ::std::setw(10) << stats.skips << ::std::setw(10) << stats.changes
+            << ::std::setw(12) << ::std::fixed << ::std::setprecision(3) << (stats.time_ns / 1e9) << ::std::endl;
+    }
+}
+
 void MIR_Optimise(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path, ::MIR::Function& fcn, const ::HIR::Function::args_t& args, const ::HIR::TypeRef& ret_type)
 {
     static Span sp;
     TRACE_FUNCTION_F(path);
     ::MIR::TypeResolve   state { sp, resolve, FMT_CB(ss, ss << path;), ret_type, args, fcn };
 
+    OptPassScheduler    sched { state, fcn };
     bool change_happened;
     unsigned int pass_num = 0;
     do
@@ -150,30 +573,33 @@ void MIR_Optimise(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path
         TRACE_FUNCTION_FR("Pass " << pass_num, change_happened);
 
         // >> Simplify call graph (removes gotos to blocks with a single use)
-        MIR_Optimise_BlockSimplify(state, fcn);
+        // - NOTE: Changes from this don't count towards `change_happened` (they can't trigger other optimisations)
+        sched.run(OptPass::BlockSimplify, [&]{ return MIR_Optimise_BlockSimplify(state, fcn); });
 
         // >> Apply known constants
-        change_happened |= MIR_Optimise_ConstPropagte(state, fcn);
+        change_happened |= sched.run(OptPass::ConstPropagate, [&]{ return MIR_Optimise_ConstPropagte(state, fcn); });
         #if CHECK_AFTER_ALL
         MIR_Validate(resolve, path, fcn, args, ret_type);
         #endif
 
         // Attempt to remove useless temporaries
-        while( MIR_Optimise_DeTemporary(state, fcn) )
-        {
-            change_happened = true;
-        }
+        change_happened |= sched.run(OptPass::DeTemporary, [&]{
+            bool rv = false;
+            while( MIR_Optimise_DeTemporary(state, fcn) )
+                rv = true;
+            return rv;
+            });
 #if CHECK_AFTER_ALL
         MIR_Validate(resolve, path, fcn, args, ret_type);
 #endif
 
         // TODO: Split apart aggregates (just tuples?) where it's never used
         // as an aggregate. (Written once, never used directly)
-        change_happened |= MIR_Optimise_SplitAggregates(state, fcn);
+        change_happened |= sched.run(OptPass::SplitAggregates, [&]{ return MIR_Optimise_SplitAggregates(state, fcn); });
 
         // >> Replace values from composites if they're known
         //   - Undoes the inefficiencies from the `match (a, b) { ... }` pattern
-        change_happened |= MIR_Optimise_PropagateKnownValues(state, fcn);
+        change_happened |= sched.run(OptPass::PropagateKnownValues, [&]{ return MIR_Optimise_PropagateKnownValues(state, fcn); });
 #if CHECK_AFTER_ALL
         MIR_Validate(resolve, path, fcn, args, ret_type);
 #endif
@@ -181,11 +607,15 @@ void MIR_Optimise(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path
         // TODO: Convert `&mut *mut_foo` into `mut_foo` if the source is movable and not used afterwards
 
 #if DUMP_BEFORE_ALL || DUMP_BEFORE_PSA
-        if( debug_enabled() ) MIR_Dump_Fcn(::std::cout, fcn);
+        if( debug_enabled() ) MIR_Dump_Fcn(debug_stream(), fcn);
 #endif
         // >> Propagate/remove dead assignments
-        while( MIR_Optimise_PropagateSingleAssignments(state, fcn) )
-            change_happened = true;
+        change_happened |= sched.run(OptPass::PropagateSingleAssignments, [&]{
+            bool rv = false;
+            while( MIR_Optimise_PropagateSingleAssignments(state, fcn) )
+                rv = true;
+            return rv;
+            });
 #if CHECK_AFTER_ALL
         MIR_Validate(resolve, path, fcn, args, ret_type);
 #endif
@@ -194,13 +624,13 @@ void MIR_Optimise(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path
         //change_happened |= MIR_Optimise_CommonStatements(state, fcn);
 
         // >> Combine Duplicate Blocks
-        change_happened |= MIR_Optimise_UnifyBlocks(state, fcn);
+        change_happened |= sched.run(OptPass::UnifyBlocks, [&]{ return MIR_Optimise_UnifyBlocks(state, fcn); });
         // >> Remove assignments of unsed drop flags
-        change_happened |= MIR_Optimise_DeadDropFlags(state, fcn);
+        change_happened |= sched.run(OptPass::DeadDropFlags, [&]{ return MIR_Optimise_DeadDropFlags(state, fcn); });
         // >> Remove assignments that are never read
-        change_happened |= MIR_Optimise_DeadAssignments(state, fcn);
+        change_happened |= sched.run(OptPass::DeadAssignments, [&]{ return MIR_Optimise_DeadAssignments(state, fcn); });
         // >> Remove no-op assignments
-        change_happened |= MIR_Optimise_NoopRemoval(state, fcn);
+        change_happened |= sched.run(OptPass::NoopRemoval, [&]{ return MIR_Optimise_NoopRemoval(state, fcn); });
 
         #if CHECK_AFTER_ALL
         MIR_Validate(resolve, path, fcn, args, ret_type);
@@ -209,12 +639,16 @@ void MIR_Optimise(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path
         // >> Inline short functions
         if( !change_happened )
         {
-            bool inline_happened = MIR_Optimise_Inlining(state, fcn, false);
-            if( inline_happened )
-            {
+            bool inline_happened = sched.run(OptPass::Inlining, [&]{
+                if( !MIR_Optimise_Inlining(state, fcn, false) )
+                    return false;
                 // Apply cleanup again (as monomorpisation in inlining may have exposed a vtable call)
                 MIR_Cleanup(resolve, path, fcn, args, ret_type);
-                //MIR_Dump_Fcn(::std::cout, fcn);
+                //MIR_Dump_Fcn(debug_stream(), fcn);
+                return true;
+                });
+            if( inline_happened )
+            {
                 change_happened = true;
             }
             #if CHECK_AFTER_ALL
@@ -226,7 +660,7 @@ void MIR_Optimise(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path
         {
             #if DUMP_AFTER_PASS
             if( debug_enabled() ) {
-                MIR_Dump_Fcn(::std::cout, fcn);
+                MIR_Dump_Fcn(debug_stream(), fcn);
             }
             #endif
             #if CHECK_AFTER_PASS && !CHECK_AFTER_ALL
@@ -234,7 +668,7 @@ void MIR_Optimise(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path
             #endif
         }
 
-        MIR_Optimise_GarbageCollect_Partial(state, fcn);
+        sched.run(OptPass::GarbageCollectPartial, [&]{ return MIR_Optimise_GarbageCollect_Partial(state, fcn); });
         pass_num += 1;
     } while( change_happened );
 
@@ -255,7 +689,7 @@ void MIR_Optimise(const StaticTraitResolve& resolve, const ::HIR::ItemPath& path
 
     #if DUMP_AFTER_DONE
     if( debug_enabled() ) {
-        MIR_Dump_Fcn(::std::cout, fcn);
+        MIR_Dump_Fcn(debug_stream(), fcn);
     }
     #endif
     #if CHECK_AFTER_DONE
@@ -305,7 +739,8 @@ namespace {
         Borrow, // Any borrow
     };
 
-    bool visit_mir_lvalues_inner(const ::MIR::LValue& lv, ValUsage u, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalues_inner(const ::MIR::LValue& lv, ValUsage u, Cb&& cb)
     {
         for(const auto& w : lv.m_wrappers)
         {
@@ -321,7 +756,8 @@ namespace {
         }
         return cb(lv, u);
     }
-    bool visit_mir_lvalue_mut(::MIR::LValue& lv, ValUsage u, ::std::function<bool(::MIR::LValue::MRef& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalue_mut(::MIR::LValue& lv, ValUsage u, Cb&& cb)
     {
         auto lvr = ::MIR::LValue::MRef(lv);
         do
@@ -359,20 +795,24 @@ namespace {
         } while( lvr.try_unwrap() );
         return false;
     }
-    bool visit_mir_lvalue(const ::MIR::LValue& lv, ValUsage u, ::std::function<bool(const ::MIR::LValue::CRef& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalue(const ::MIR::LValue& lv, ValUsage u, Cb&& cb)
     {
         return visit_mir_lvalue_mut( const_cast<::MIR::LValue&>(lv), u, [&](auto& v, auto u) { return cb(v,u); } );
     }
-    bool visit_mir_lvalue_raw_mut(::MIR::LValue& lv, ValUsage u, ::std::function<bool(::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalue_raw_mut(::MIR::LValue& lv, ValUsage u, Cb&& cb)
     {
         return cb(lv, u);
     }
-    bool visit_mir_lvalue_raw(const ::MIR::LValue& lv, ValUsage u, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalue_raw(const ::MIR::LValue& lv, ValUsage u, Cb&& cb)
     {
         return cb(lv, u);
     }
 
-    bool visit_mir_lvalue_mut(::MIR::Param& p, ValUsage u, ::std::function<bool(::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalue_mut(::MIR::Param& p, ValUsage u, Cb&& cb)
     {
         if( auto* e = p.opt_LValue() )
         {
@@ -383,7 +823,8 @@ namespace {
             return false;
         }
     }
-    bool visit_mir_lvalue(const ::MIR::Param& p, ValUsage u, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalue(const ::MIR::Param& p, ValUsage u, Cb&& cb)
     {
         if( const auto* e = p.opt_LValue() )
         {
@@ -395,7 +836,8 @@ namespace {
         }
     }
 
-    bool visit_mir_lvalues_mut(::MIR::RValue& rval, ::std::function<bool(::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalues_mut(::MIR::RValue& rval, Cb&& cb)
     {
         bool rv = false;
         TU_MATCHA( (rval), (se),
@@ -448,12 +890,14 @@ namespace {
         )
         return rv;
     }
-    bool visit_mir_lvalues(const ::MIR::RValue& rval, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalues(const ::MIR::RValue& rval, Cb&& cb)
     {
         return visit_mir_lvalues_mut(const_cast<::MIR::RValue&>(rval), [&](auto& lv, auto u){ return cb(lv, u); });
     }
 
-    bool visit_mir_lvalues_mut(::MIR::Statement& stmt, ::std::function<bool(::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalues_mut(::MIR::Statement& stmt, Cb&& cb)
     {
         bool rv = false;
         TU_MATCHA( (stmt), (e),
@@ -478,12 +922,14 @@ namespace {
         )
         return rv;
     }
-    bool visit_mir_lvalues(const ::MIR::Statement& stmt, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalues(const ::MIR::Statement& stmt, Cb&& cb)
     {
         return visit_mir_lvalues_mut(const_cast<::MIR::Statement&>(stmt), [&](auto& lv, auto im){ return cb(lv, im); });
     }
 
-    bool visit_mir_lvalues_mut(::MIR::Terminator& term, ::std::function<bool(::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalues_mut(::MIR::Terminator& term, Cb&& cb)
     {
         bool rv = false;
         TU_MATCHA( (term), (e),
@@ -517,12 +963,14 @@ namespace {
         )
         return rv;
     }
-    bool visit_mir_lvalues(const ::MIR::Terminator& term, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    bool visit_mir_lvalues(const ::MIR::Terminator& term, Cb&& cb)
     {
         return visit_mir_lvalues_mut(const_cast<::MIR::Terminator&>(term), [&](auto& lv, auto im){ return cb(lv, im); });
     }
 
-    void visit_mir_lvalues_mut(::MIR::TypeResolve& state, ::MIR::Function& fcn, ::std::function<bool(::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    void visit_mir_lvalues_mut(::MIR::TypeResolve& state, ::MIR::Function& fcn, Cb&& cb)
     {
         for(unsigned int block_idx = 0; block_idx < fcn.blocks.size(); block_idx ++)
         {
@@ -538,7 +986,8 @@ namespace {
             visit_mir_lvalues_mut(block.terminator, cb);
         }
     }
-    void visit_mir_lvalues(::MIR::TypeResolve& state, const ::MIR::Function& fcn, ::std::function<bool(const ::MIR::LValue& , ValUsage)> cb)
+    template<typename Cb>
+    void visit_mir_lvalues(::MIR::TypeResolve& state, const ::MIR::Function& fcn, Cb&& cb)
     {
         visit_mir_lvalues_mut(state, const_cast<::MIR::Function&>(fcn), [&](auto& lv, auto im){ return cb(lv, im); });
     }
@@ -562,8 +1011,8 @@ namespace {
         // If a TransList is avaliable, then all referenced functions must be in it.
         if( list )
         {
-            auto it = list->m_functions.find(path);
-            if( it == list->m_functions.end() )
+            const auto* it = list->m_functions.find(path);
+            if( !it )
             {
                 MIR_BUG(state, "Enumeration failure - Function " << path << " not in TransList");
             }
@@ -705,7 +1154,8 @@ namespace {
     }
 
 
-    void visit_terminator_target_mut(::MIR::Terminator& term, ::std::function<void(::MIR::BasicBlockId&)> cb) {
+    template<typename Cb>
+    void visit_terminator_target_mut(::MIR::Terminator& term, Cb&& cb) {
         TU_MATCHA( (term), (e),
         (Incomplete,
             ),
@@ -737,11 +1187,13 @@ namespace {
             )
         )
     }
-    void visit_terminator_target(const ::MIR::Terminator& term, ::std::function<void(const ::MIR::BasicBlockId&)> cb) {
+    template<typename Cb>
+    void visit_terminator_target(const ::MIR::Terminator& term, Cb&& cb) {
         visit_terminator_target_mut(const_cast<::MIR::Terminator&>(term), cb);
     }
 
-    void visit_blocks_mut(::MIR::TypeResolve& state, ::MIR::Function& fcn, ::std::function<void(::MIR::BasicBlockId, ::MIR::BasicBlock&)> cb)
+    template<typename Cb>
+    void visit_blocks_mut(::MIR::TypeResolve& state, ::MIR::Function& fcn, Cb&& cb)
     {
         ::std::vector<bool> visited( fcn.blocks.size() );
         ::std::vector< ::MIR::BasicBlockId> to_visit;
@@ -761,8 +1213,9 @@ namespace {
                 });
         }
     }
-    void visit_blocks(::MIR::TypeResolve& state, const ::MIR::Function& fcn, ::std::function<void(::MIR::BasicBlockId, const ::MIR::BasicBlock&)> cb) {
-        visit_blocks_mut(state, const_cast<::MIR::Function&>(fcn), [cb](auto id, auto& blk){ cb(id, blk); });
+    template<typename Cb>
+    void visit_blocks(::MIR::TypeResolve& state, const ::MIR::Function& fcn, Cb&& cb) {
+        visit_blocks_mut(state, const_cast<::MIR::Function&>(fcn), [&](auto id, auto& blk){ cb(id, blk); });
     }
 }
 
@@ -772,6 +1225,7 @@ namespace {
 // --------------------------------------------------------------------
 bool MIR_Optimise_BlockSimplify(::MIR::TypeResolve& state, ::MIR::Function& fcn)
 {
+    bool changed = false;
     // >> Replace targets that point to a block that is just a goto
     for(auto& block : fcn.blocks)
     {
@@ -789,6 +1243,7 @@ bool MIR_Optimise_BlockSimplify(::MIR::TypeResolve& state, ::MIR::Function& fcn)
                         dst.slots.push_back(v);
                     ::std::sort(dst.slots.begin(), dst.slots.end());
                     it = block.statements.erase(it);
+                    changed = true;
                 }
                 else
                 {
@@ -798,8 +1253,13 @@ bool MIR_Optimise_BlockSimplify(::MIR::TypeResolve& state, ::MIR::Function& fcn)
         }
 
         visit_terminator_target_mut(block.terminator, [&](auto& e) {
-            if( &fcn.blocks[e] != &block )
-                e = get_new_target(state, e);
+            if( &fcn.blocks[e] != &block ) {
+                auto new_e = get_new_target(state, e);
+                if( new_e != e ) {
+                    e = new_e;
+                    changed = true;
+                }
+            }
             });
     }
 
@@ -846,14 +1306,15 @@ bool MIR_Optimise_BlockSimplify(::MIR::TypeResolve& state, ::MIR::Function& fcn)
                     for(auto& stmt : src_block.statements)
                         block.statements.push_back( mv$(stmt) );
                     block.terminator = mv$( src_block.terminator );
+                    changed = true;
                 }
             }
             i ++;
         }
     }
 
-    // NOTE: Not strictly true, but these can't trigger other optimisations
-    return false;
+    // NOTE: Callers don't count this as a change that can trigger other optimisations, but the return value is accurate
+    return changed;
 }
 
 
@@ -1425,10 +1886,12 @@ namespace {
         EarlyTrue,
         Complete,
     };
+    // - `cb_stmt` is `bool(StmtRef, const ::MIR::Statement&)`, `cb_term` is `bool(StmtRef, const ::MIR::Terminator&)`
+    template<typename CbStmt, typename CbTerm>
     IterPathRes iter_path(
             const ::MIR::Function& fcn, const StmtRef& start, const StmtRef& end,
-            ::std::function<bool(StmtRef, const ::MIR::Statement&)> cb_stmt,
-            ::std::function<bool(StmtRef, const ::MIR::Terminator&)> cb_term
+            CbStmt&& cb_stmt,
+            CbTerm&& cb_term
             )
     {
         if( start.bb_idx == end.bb_idx ) {
@@ -1502,7 +1965,7 @@ namespace {
         return IterPathRes::Complete;
     }
 
-    ::std::function<bool(const ::MIR::LValue& , ValUsage)> check_invalidates_lvalue_cb(const ::MIR::LValue& val, bool also_read=false)
+    auto check_invalidates_lvalue_cb(const ::MIR::LValue& val, bool also_read=false)
     {
         bool has_index = ::std::any_of(val.m_wrappers.begin(), val.m_wrappers.end(), [](const auto& w){ return w.is_Index(); });
         // Value is invalidated if it's used with ValUsage::Write or ValUsage::Borrow
@@ -2773,7 +3236,7 @@ bool MIR_Optimise_PropagateKnownValues(::MIR::TypeResolve& state, ::MIR::Functio
 bool MIR_Optimise_ConstPropagte(::MIR::TypeResolve& state, ::MIR::Function& fcn)
 {
 #if DUMP_BEFORE_ALL || DUMP_BEFORE_CONSTPROPAGATE
-    if( debug_enabled() ) MIR_Dump_Fcn(::std::cout, fcn);
+    if( debug_enabled() ) MIR_Dump_Fcn(debug_stream(), fcn);
 #endif
     bool changed = false;
     TRACE_FUNCTION_FR("", changed);
@@ -2933,6 +3396,7 @@ bool MIR_Optimise_ConstPropagte(::MIR::TypeResolve& state, ::MIR::Function& fcn)
                 else
                 {
                     p = mv$(nv);
+                    changed = true;
                 }
             }
             };
@@ -2957,6 +3421,7 @@ bool MIR_Optimise_ConstPropagte(::MIR::TypeResolve& state, ::MIR::Function& fcn)
                     else
                     {
                         e->src = ::MIR::RValue::make_Constant(mv$(nv));
+                        changed = true;
                     }
                     ),
                 (Constant,
@@ -3276,6 +3741,7 @@ bool MIR_Optimise_ConstPropagte(::MIR::TypeResolve& state, ::MIR::Function& fcn)
                             // TODO: Delete drop
                             stmt = ::MIR::Statement::make_ScopeEnd({ });
                         }
+                        changed = true;
                     }
                 }
             }
@@ -4327,7 +4793,8 @@ bool MIR_Optimise_GarbageCollect_Partial(::MIR::TypeResolve& state, ::MIR::Funct
     bool rv = false;
     for(unsigned int i = 0; i < visited.size(); i ++)
     {
-        if( !visited[i] )
+        // NOTE: Already-cleared blocks aren't counted as a change
+        if( !visited[i] && !(fcn.blocks[i].statements.empty() && fcn.blocks[i].terminator.is_Incomplete()) )
         {
             DEBUG("CLEAR bb" << i);
             fcn.blocks[i].statements.clear();
@@ -4688,67 +5155,284 @@ void MIR_SortBlocks(const StaticTraitResolve& resolve, const ::HIR::ItemPath& pa
 }
 
 
+namespace {
+    /// Splits a call graph into strongly connected components (recursive groups), ordered callees-first: every callee
+    /// of a component's members is either in that component or in an earlier one.
+    /// - `get_callees(i)` returns the nodes called by node `i` (of `num_nodes`)
+    /// - Tarjan's SCC algorithm, iterative as call chains can be deep
+    template<typename Cb>
+    ::std::vector< ::std::vector<size_t> > get_call_graph_sccs(size_t num_nodes, Cb get_callees)
+    {
+        ::std::vector< ::std::vector<size_t> >  rv;
+        const size_t UNVISITED = SIZE_MAX;
+        ::std::vector<size_t>   index(num_nodes, UNVISITED);
+        ::std::vector<size_t>   lowlink(num_nodes);
+        ::std::vector<bool> on_stack(num_nodes);
+        ::std::vector<size_t>   scc_stack;
+        ::std::vector< ::std::pair<size_t,size_t> > dfs_stack;   // (node, next callee)
+        size_t  next_index = 0;
+        for(size_t root = 0; root < num_nodes; root ++)
+        {
+            if( index[root] != UNVISITED )
+                continue ;
+            dfs_stack.push_back(::std::make_pair(root, 0));
+            index[root] = lowlink[root] = next_index++;
+            scc_stack.push_back(root);
+            on_stack[root] = true;
+            while( !dfs_stack.empty() )
+            {
+                auto& top = dfs_stack.back();
+                size_t  v = top.first;
+                const ::std::vector<size_t>& callees = get_callees(v);
+                if( top.second < callees.size() )
+                {
+                    size_t w = callees[top.second++];
+                    if( index[w] == UNVISITED ) {
+                        index[w] = lowlink[w] = next_index++;
+                        scc_stack.push_back(w);
+                        on_stack[w] = true;
+                        dfs_stack.push_back(::std::make_pair(w, 0));
+                    }
+                    else if( on_stack[w] ) {
+                        lowlink[v] = ::std::min(lowlink[v], index[w]);
+                    }
+                }
+                else
+                {
+                    dfs_stack.pop_back();
+                    if( !dfs_stack.empty() ) {
+                        size_t u = dfs_stack.back().first;
+                        lowlink[u] = ::std::min(lowlink[u], lowlink[v]);
+                    }
+                    if( lowlink[v] == index[v] ) {
+                        ::std::vector<size_t>   scc;
+                        size_t w;
+                        do {
+                            w = scc_stack.back();
+                            scc_stack.pop_back();
+                            on_stack[w] = false;
+                            scc.push_back(w);
+                        } while( w != v );
+                        rv.push_back(::std::move(scc));
+                    }
+                }
+            }
+        }
+        return rv;
+    }
+}
+
 void MIR_OptimiseCrate(::HIR::Crate& crate, bool do_minimal_optimisation)
 {
-    ::MIR::OuterVisitor ov { crate, [do_minimal_optimisation](const auto& res, const auto& p, auto& expr, const auto& args, const auto& ty)
+    auto optimise = [&](const auto& res, const auto& p, ::MIR::Function& mir, const auto& args, const auto& ty) {
+        if( do_minimal_optimisation ) {
+            MIR_OptimiseMin(res, p, mir, args, ty);
+        }
+        else {
+            MIR_Optimise(res, p, mir, args, ty);
+        }
+        };
+
+    if( g_num_threads <= 1 )
+    {
+        // Serial: optimise in-place in visit order, so inlining sees callees that have already been optimised
+        ::MIR::OuterVisitor ov { crate, [&](const auto& res, const auto& p, auto& expr, const auto& args, const auto& ty)
+            {
+                if( ! dynamic_cast<::HIR::ExprNode_Block*>(expr.get()) ) {
+                    return ;
+                }
+                optimise(res, p, expr.get_mir_or_error_mut(Span()), args, ty);
+            }
+            };
+        ov.visit_crate(crate);
+        return ;
+    }
+
+    // Parallel: inlining reads other bodies from this crate, so bodies are optimised in-place in waves following the
+    // call graph. A body's wave is after those of all of its callees, so it only ever reads finished bodies.
+    // - Members of a recursive group get consecutive waves (in visit order), as they read each other.
+    struct Node {
+        ::std::vector<size_t>   callees;
+        unsigned    wave = 0;
+    };
+    ::std::vector<Node> nodes;
+    ::std::map<const ::MIR::Function*, size_t>  node_idx;
+    {
+        ::MIR::OuterVisitor ov { crate, [&](const auto& res, const auto& p, auto& expr, const auto& args, const auto& ty)
+            {
+                if( ! dynamic_cast<::HIR::ExprNode_Block*>(expr.get()) ) {
+                    return ;
+                }
+                node_idx.insert(::std::make_pair(&expr.get_mir_or_error(Span()), nodes.size()));
+                nodes.push_back(Node());
+            }
+            };
+        ov.visit_crate(crate);
+    }
+    // Call graph edges (only calls to bodies in this crate matter)
+    {
+        ::MIR::OuterVisitor ov { crate, [&](const auto& res, const auto& p, auto& expr, const auto& args, const auto& ty)
+            {
+                if( ! dynamic_cast<::HIR::ExprNode_Block*>(expr.get()) ) {
+                    return ;
+                }
+                static Span sp;
+                const auto& mir = expr.get_mir_or_error(sp);
+                ::MIR::TypeResolve   state { sp, res, FMT_CB(ss, ss << p;), ty, args, mir };
+                auto& callees = nodes[node_idx.at(&mir)].callees;
+                for(const auto& bb : mir.blocks)
+                {
+                    if( !bb.terminator.is_Call() || !bb.terminator.as_Call().fcn.is_Path() )
+                        continue ;
+                    ParamsSet   params;
+                    auto it = node_idx.find( get_called_mir(state, nullptr, bb.terminator.as_Call().fcn.as_Path(), params) );
+                    if( it != node_idx.end() && ::std::find(callees.begin(), callees.end(), it->second) == callees.end() )
+                        callees.push_back(it->second);
+                }
+            }
+            };
+        ov.visit_crate_parallel(crate);
+    }
+
+    // Assign waves bottom-up, callees outside of a recursive group have already been assigned so their waves are final
+    for(auto& scc : get_call_graph_sccs(nodes.size(), [&](size_t i)->const ::std::vector<size_t>& { return nodes[i].callees; }))
+    {
+        unsigned first_wave = 0;
+        for(auto m : scc)
+            for(auto e : nodes[m].callees)
+                if( ::std::find(scc.begin(), scc.end(), e) == scc.end() )
+                    first_wave = ::std::max(first_wave, nodes[e].wave + 1);
+        ::std::sort(scc.begin(), scc.end());
+        for(size_t i = 0; i < scc.size(); i ++)
+            nodes[scc[i]].wave = first_wave + i;
+    }
+
+    ::MIR::OuterVisitor ov { crate, [&](const auto& res, const auto& p, auto& expr, const auto& args, const auto& ty)
         {
             if( ! dynamic_cast<::HIR::ExprNode_Block*>(expr.get()) ) {
                 return ;
             }
-            auto& mir = expr.get_mir_or_error_mut(Span());
-            if( do_minimal_optimisation ) {
-                MIR_OptimiseMin(res, p, mir, args, ty);
-            }
-            else {
-                MIR_Optimise(res, p, mir, args, ty);
-            }
+            optimise(res, p, expr.get_mir_or_error_mut(Span()), args, ty);
         }
         };
-    ov.visit_crate(crate);
+    ov.visit_crate_waves(crate, [&](const ::HIR::ExprPtr& expr)->unsigned {
+        const auto* mir = expr.get_mir_opt();
+        auto it = mir ? node_idx.find(mir) : node_idx.end();
+        return it != node_idx.end() ? nodes[it->second].wave : 0;
+        });
 }
 
-void MIR_OptimiseCrate_Inlining(const ::HIR::Crate& crate, TransList& list)
+void MIR_OptimiseCrate_Inlining(const ::HIR::Crate& crate, TransList& list, size_t size_budget)
 {
     ::StaticTraitResolve    resolve { crate };
 
-    bool did_inline_on_pass;
+    // Maximum number of times a function is re-processed (limits churn within recursive call groups)
+    const unsigned  MAX_VISITS = 5;
 
-    size_t  MAX_ITERATIONS = 5; // TODO: Tune this.
-    size_t  num_iterations = 0;
-    do
+    struct Node {
+        const ::HIR::Path*  path;
+        TransList_Function* ent;
+        ::MIR::Function*    mir;
+        ::std::vector<size_t>   callees;
+        ::std::vector<size_t>   callers;
+        unsigned    num_visits = 0;
+    };
+    ::std::vector<Node> nodes;
+    ::std::map<const ::HIR::Path*, size_t>  node_idx_by_ptr;
+    for(auto& fcn_ent : list.m_functions)
     {
-        did_inline_on_pass = false;
+        Node    n;
+        n.path = &fcn_ent.first;
+        n.ent = &*fcn_ent.second;
+        auto& hir_fcn = *const_cast<::HIR::Function*>(fcn_ent.second->ptr);
+        if( fcn_ent.second->monomorphised.code ) {
+            n.mir = &*fcn_ent.second->monomorphised.code;
+        }
+        else if( hir_fcn.m_code ) {
+            n.mir = &hir_fcn.m_code.get_mir_or_error_mut(Span());
+        }
+        else {
+            // Extern, no optimisations
+            continue ;
+        }
+        node_idx_by_ptr.insert(::std::make_pair(n.path, nodes.size()));
+        nodes.push_back(::std::move(n));
+    }
 
-        for(auto& fcn_ent : list.m_functions)
+    // Call graph edges (only calls to functions with MIR matter)
+    auto get_node = [&](const ::HIR::Path& p)->size_t {
+        const auto* it = list.m_functions.find(p);
+        if( !it )
+            return SIZE_MAX;
+        auto it2 = node_idx_by_ptr.find(&it->first);
+        return it2 == node_idx_by_ptr.end() ? SIZE_MAX : it2->second;
+        };
+    auto add_edges = [&](size_t caller) {
+        for(const auto& bb : nodes[caller].mir->blocks)
         {
-            const auto& path = fcn_ent.first;
-            //const auto& pp = fcn_ent.second->pp;
-            auto& hir_fcn = *const_cast<::HIR::Function*>(fcn_ent.second->ptr);
-            auto& mono_fcn = fcn_ent.second->monomorphised;
+            if( !bb.terminator.is_Call() || !bb.terminator.as_Call().fcn.is_Path() )
+                continue ;
+            auto callee = get_node(bb.terminator.as_Call().fcn.as_Path());
+            if( callee == SIZE_MAX )
+                continue ;
+            auto& ces = nodes[caller].callees;
+            if( ::std::find(ces.begin(), ces.end(), callee) == ces.end() ) {
+                ces.push_back(callee);
+                nodes[callee].callers.push_back(caller);
+            }
+        }
+        };
+    for(size_t i = 0; i < nodes.size(); i ++)
+        add_edges(i);
+
+    // Order the functions so callees come before their callers
+    ::std::vector<size_t>   order;
+    for(const auto& scc : get_call_graph_sccs(nodes.size(), [&](size_t i)->const ::std::vector<size_t>& { return nodes[i].callees; }))
+        order.insert(order.end(), scc.begin(), scc.end());
+
+    // Worklist: process each function once in bottom-up order, then re-queue the callers of anything that changed
+    ::std::deque<size_t>    queue(order.begin(), order.end());
+    ::std::vector<bool> in_queue(nodes.size(), true);
+    size_t  num_processed = 0;
+    while( !queue.empty() )
+    {
+        auto idx = queue.front();
+        queue.pop_front();
+        in_queue[idx] = false;
+        auto& n = nodes[idx];
+        if( n.num_visits >= MAX_VISITS ) {
+            DEBUG("Visit limit hit for " << *n.path);
+            continue ;
+        }
+        n.num_visits += 1;
+        num_processed += 1;
 
-            ::std::string s = FMT(path);
-            ::HIR::ItemPath ip(s);
+        ::HIR::ItemPath ip(*n.path);
+        bool changed;
+        if( n.ent->monomorphised.code )
+        {
+            const auto& mono_fcn = n.ent->monomorphised;
+            changed = MIR_OptimiseInline(resolve, ip, *n.mir, mono_fcn.arg_tys, mono_fcn.ret_ty, list, size_budget);
+        }
+        else
+        {
+            const auto& hir_fcn = *n.ent->ptr;
+            changed = MIR_OptimiseInline(resolve, ip, *n.mir, hir_fcn.m_args, hir_fcn.m_return, list, size_budget);
+            n.mir->trans_enum_state = ::MIR::EnumCachePtr();   // Clear MIR enum cache
+        }
 
-            if( mono_fcn.code )
-            {
-                did_inline_on_pass |= MIR_OptimiseInline(resolve, ip, *mono_fcn.code, mono_fcn.arg_tys, mono_fcn.ret_ty, list);
-            }
-            else if( hir_fcn.m_code )
-            {
-                auto& mir = hir_fcn.m_code.get_mir_or_error_mut(Span());
-                bool did_opt = MIR_OptimiseInline(resolve, ip, mir, hir_fcn.m_args, hir_fcn.m_return, list);
-                mir.trans_enum_state = ::MIR::EnumCachePtr();   // Clear MIR enum cache
-                did_inline_on_pass |= did_opt;
-            }
-            else
+        if( changed )
+        {
+            // Inlined bodies bring in new callees
+            add_edges(idx);
+            for(auto caller : nodes[idx].callers)
             {
-                // Extern, no optimisations
+                if( !in_queue[caller] ) {
+                    queue.push_back(caller);
+                    in_queue[caller] = true;
+                }
             }
         }
-    } while( did_inline_on_pass && num_iterations < MAX_ITERATIONS );
-
-    if( did_inline_on_pass )
-    {
-        DEBUG("Ran inlining optimise pass to exhaustion (maximum of " << MAX_ITERATIONS << " hit");
     }
+    DEBUG(num_processed << " inlining runs for " << nodes.size() << " functions");
 }
@@ -7,6 +7,111 @@
  */
 #include "visit_crate_mir.hpp"
 #include <hir/expr.hpp>
+#include <thread_pool.hpp>
+#include <algorithm>  // std::reverse
+
+/// A body collected by `visit_crate_parallel`, with the state needed to process it later
+struct MIR::OuterVisitor::Job
+{
+    const ::HIR::GenericParams* impl_generics;
+    const ::HIR::GenericParams* item_generics;
+    // Owned copy of the item path chain (the visitor's paths live on the stack), last entry is the item itself
+    // - Everything else the path points to is owned by the HIR, except trait paths (which are copied)
+    ::std::vector< ::HIR::ItemPath>    path_nodes;
+    ::std::vector< ::std::unique_ptr< ::HIR::SimplePath> >  path_traits;
+    ::HIR::ExprPtr* expr;
+    const ::HIR::Function::args_t*  args;
+    ::HIR::TypeRef  ret_type;
+
+    Job(const StaticTraitResolve& resolve, const ::HIR::ItemPath& p, ::HIR::ExprPtr& expr, const ::HIR::Function::args_t& args, const ::HIR::TypeRef& ret_type):
+        impl_generics(resolve.m_impl_generics),
+        item_generics(resolve.m_item_generics),
+        expr(&expr),
+        // NOTE: Non-function bodies pass a temporary empty list
+        args(args.empty() ? nullptr : &args),
+        ret_type(ret_type.clone())
+    {
+        for(const auto* n = &p; n; n = n->parent)
+            path_nodes.push_back(*n);
+        ::std::reverse(path_nodes.begin(), path_nodes.end());
+        for(size_t i = 0; i < path_nodes.size(); i ++)
+        {
+            auto& n = path_nodes[i];
+            n.parent = (i > 0 ? &path_nodes[i-1] : nullptr);
+            if( n.trait )
+            {
+                path_traits.push_back(::std::unique_ptr< ::HIR::SimplePath>(new ::HIR::SimplePath(n.trait->clone())));
+                n.trait = path_traits.back().get();
+            }
+        }
+    }
+    Job(const Job&) = delete;
+};
+
+MIR::OuterVisitor::~OuterVisitor()
+{
+}
+
+void MIR::OuterVisitor::visit_crate_parallel(::HIR::Crate& crate)
+{
+    ::std::vector< ::std::unique_ptr<Job> > jobs;
+    m_jobs = &jobs;
+    this->visit_crate(crate);
+    m_jobs = nullptr;
+
+    ThreadPool  pool;
+    pool.for_each_index(jobs.size(), [&](size_t i) {
+        this->run_job(crate, *jobs[i]);
+        });
+}
+void MIR::OuterVisitor::visit_crate_waves(::HIR::Crate& crate, ::std::function<unsigned(const ::HIR::ExprPtr&)> get_wave)
+{
+    ::std::vector< ::std::unique_ptr<Job> > jobs;
+    m_jobs = &jobs;
+    this->visit_crate(crate);
+    m_jobs = nullptr;
+
+    // Bucket the jobs by wave (keeping the visit order within each wave)
+    ::std::vector< ::std::vector<const Job*> >  waves;
+    for(const auto& job : jobs)
+    {
+        auto w = get_wave(*job->expr);
+        if( w >= waves.size() )
+            waves.resize(w + 1);
+        waves[w].push_back(job.get());
+    }
+
+    ThreadPool  pool;
+    for(const auto& wave : waves)
+    {
+        pool.for_each_index(wave.size(), [&](size_t i) {
+            this->run_job(crate, *wave[i]);
+            });
+    }
+}
+void MIR::OuterVisitor::run_job(const ::HIR::Crate& crate, const Job& job)
+{
+    static const ::HIR::Function::args_t   empty_args;
+    // Each body gets its own resolver, as the generics in scope differ between items
+    StaticTraitResolve  resolve { crate };
+    if( job.impl_generics )
+        resolve.set_impl_generics_raw(*job.impl_generics);
+    if( job.item_generics )
+        resolve.set_item_generics_raw(*job.item_generics);
+    m_cb(resolve, job.path_nodes.back(), *job.expr, job.args ? *job.args : empty_args, job.ret_type);
+}
+
+void MIR::OuterVisitor::handle_body(const ::HIR::ItemPath& p, ::HIR::ExprPtr& expr, const ::HIR::Function::args_t& args, const ::HIR::TypeRef& ret_type)
+{
+    if( m_jobs )
+    {
+        m_jobs->push_back(::std::unique_ptr<Job>(new Job(m_resolve, p, expr, args, ret_type)));
+    }
+    else
+    {
+        m_cb(m_resolve, p, expr, args, ret_type);
+    }
+}
 
 // NOTE: This is left here to ensure that any expressions that aren't handled by higher code cause a failure
 void MIR::OuterVisitor::visit_expr(::HIR::ExprPtr& exp)
@@ -20,7 +125,7 @@ void MIR::OuterVisitor::visit_type(::HIR::TypeRef& ty)
         this->visit_type( *e.inner );
         DEBUG("Array size " << ty);
         if( e.size ) {
-            m_cb(m_resolve, ::HIR::ItemPath(""), *e.size, {}, ::HIR::TypeRef(::HIR::CoreType::Usize));
+            this->handle_body(::HIR::ItemPath(""), *e.size, {}, ::HIR::TypeRef(::HIR::CoreType::Usize));
         }
     )
     else {
@@ -34,21 +139,21 @@ void MIR::OuterVisitor::visit_function(::HIR::ItemPath p, ::HIR::Function& item)
     if( item.m_code )
     {
         DEBUG("Function code " << p);
-        m_cb(m_resolve, p, item.m_code, item.m_args, item.m_return);
+        this->handle_body(p, item.m_code, item.m_args, item.m_return);
     }
 }
 void MIR::OuterVisitor::visit_static(::HIR::ItemPath p, ::HIR::Static& item)
 {
     if( item.m_value ) {
         DEBUG("`static` value " << p);
-        m_cb(m_resolve, p, item.m_value, {}, item.m_type);
+        this->handle_body(p, item.m_value, {}, item.m_type);
     }
 }
 void MIR::OuterVisitor::visit_constant(::HIR::ItemPath p, ::HIR::Constant& item)
 {
     if( item.m_value ) {
         DEBUG("`const` value " << p);
-        m_cb(m_resolve, p, item.m_value, {}, item.m_type);
+        this->handle_body(p, item.m_value, {}, item.m_type);
     }
 }
 void MIR::OuterVisitor::visit_enum(::HIR::ItemPath p, ::HIR::Enum& item)
@@ -62,7 +167,7 @@ void MIR::OuterVisitor::visit_enum(::HIR::ItemPath p, ::HIR::Enum& item)
         for(auto& var : e->variants)
         {
             if( var.expr ) {
-                m_cb(m_resolve, p + var.name, var.expr, {}, enum_type);
+                this->handle_body(p + var.name, var.expr, {}, enum_type);
             }
         }
     }
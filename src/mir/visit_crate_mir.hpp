@@ -19,11 +19,23 @@ public:
 private:
     StaticTraitResolve  m_resolve;
     cb_t  m_cb;
+
+    struct Job;
+    /// When set, bodies are collected here (for `visit_crate_parallel`) instead of being passed to the callback
+    ::std::vector< ::std::unique_ptr<Job> >*    m_jobs = nullptr;
 public:
     OuterVisitor(const ::HIR::Crate& crate, cb_t cb):
         m_resolve(crate),
         m_cb(cb)
     {}
+    ~OuterVisitor();
+
+    /// Visit all bodies in the crate, running the callback for each on the thread pool
+    /// - Bodies are collected first (in the same order as `visit_crate`), so the callback must only modify the body it's given
+    void visit_crate_parallel(::HIR::Crate& crate);
+    /// Visit all bodies in the crate on the thread pool, in a sequence of waves
+    /// - Bodies are run in increasing order of `get_wave(body)`, a wave only starting once the previous one has finished
+    void visit_crate_waves(::HIR::Crate& crate, ::std::function<unsigned(const ::HIR::ExprPtr&)> get_wave);
 
     void visit_expr(::HIR::ExprPtr& exp) override;
 
@@ -41,6 +53,10 @@ public:
     void visit_trait(::HIR::ItemPath p, ::HIR::Trait& item) override;
     void visit_type_impl(::HIR::TypeImpl& impl) override;
     void visit_trait_impl(const ::HIR::SimplePath& trait_path, ::HIR::TraitImpl& impl) override;
+
+private:
+    void run_job(const ::HIR::Crate& crate, const Job& job);
+    void handle_body(const ::HIR::ItemPath& p, ::HIR::ExprPtr& expr, const ::HIR::Function::args_t& args, const ::HIR::TypeRef& ret_type);
 };
 
 
@@ -15,6 +15,7 @@
 #include <typeinfo>
 #include <algorithm>    // std::count
 #include <cctype>
+#include <fstream>
 //#define TRACE_CHARS
 //#define TRACE_RAW_TOKENS
 
@@ -22,17 +23,33 @@ Lexer::Lexer(const ::std::string& filename):
     m_path(filename.c_str()),
     m_line(1),
     m_line_ofs(0),
-    m_istream(filename.c_str()),
     m_last_char_valid(false),
     m_hygiene( Ident::Hygiene::new_scope() )
 {
-    if( !m_istream.is_open() )
+    // Read the whole file up-front, so the lexer can scan a buffer instead of doing per-byte stream calls
     {
-        throw ::std::runtime_error("Unable to open file '" + filename + "'");
+        ::std::ifstream is(filename.c_str(), ::std::ios::binary);
+        if( !is.is_open() )
+        {
+            throw ::std::runtime_error("Unable to open file '" + filename + "'");
+        }
+        is.seekg(0, ::std::ios::end);
+        auto len = is.tellg();
+        is.seekg(0, ::std::ios::beg);
+        if( len > 0 )
+        {
+            m_source.resize(static_cast<size_t>(len));
+            is.read(m_source.data(), len);
+            m_source.resize(static_cast<size_t>(is.gcount()));
+        }
     }
+    m_cur = m_source.data();
+    m_end = m_cur + m_source.size();
+
     // Consume the BOM
-    if( this->getc_byte() == '\xef' )
+    if( m_cur != m_end && *m_cur == '\xef' )
     {
+        m_cur ++;
         if( this->getc_byte() != '\xbb' ) {
             throw ::std::runtime_error("Incomplete BOM - missing \\xBB in second position");
         }
@@ -41,10 +58,6 @@ Lexer::Lexer(const ::std::string& filename):
         }
         m_line_ofs = 0;
     }
-    else
-    {
-        m_istream.unget();
-    }
 }
 
 
@@ -316,6 +329,12 @@ Token Lexer::getTokenInt()
             return Token(TOK_NEWLINE);
         if( ch.isspace() )
         {
+            // Fast path: skip plain ASCII whitespace directly in the buffer
+            while( m_cur != m_end && (*m_cur == ' ' || *m_cur == '\t' || *m_cur == '\r') )
+            {
+                m_cur ++;
+                m_line_ofs ++;
+            }
             while( (ch = this->getc()).isspace() && ch != '\n' )
                 ;
             this->ungetc();
@@ -817,6 +836,15 @@ Token Lexer::getTokenInt_Identifier(Codepoint leader, Codepoint leader2)
     while( issym(ch) )
     {
         str += ch;
+        // Fast path: consume a run of ASCII identifier characters directly from the buffer
+        if( !m_last_char_valid )
+        {
+            const char* start = m_cur;
+            while( m_cur != m_end && (::std::isalnum(static_cast<unsigned char>(*m_cur)) || *m_cur == '_') )
+                m_cur ++;
+            str.append(start, m_cur);
+            m_line_ofs += m_cur - start;
+        }
         ch = this->getc();
     }
 
@@ -942,9 +970,9 @@ uint32_t Lexer::parseEscape(char enclosing)
 
 char Lexer::getc_byte()
 {
-    int rv = m_istream.get();
-    if( rv == EOF || m_istream.eof() )
+    if( m_cur == m_end )
         throw Lexer::EndOfFile();
+    char rv = *m_cur++;
 
     if( rv == '\n' )
     {
@@ -39,7 +39,11 @@ class Lexer:
     unsigned int m_line;
     unsigned int m_line_ofs;
 
-    ::std::ifstream m_istream;
+    /// Entire source file, scanned by pointer
+    /// - A vector so the pointers stay valid when the lexer is moved
+    ::std::vector<char> m_source;
+    const char* m_cur;
+    const char* m_end;
     bool    m_last_char_valid;
     Codepoint   m_last_char;
     ::std::vector<Token>    m_next_tokens;
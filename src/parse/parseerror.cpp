@@ -58,24 +58,18 @@ ParseError::BadChar::~BadChar() throw()
 ParseError::Unexpected::Unexpected(const TokenStream& lex, const Token& tok)//:
 //    m_tok( mv$(tok) )
 {
-    Span pos = tok.get_pos();
-    if(pos.filename == "")
-        pos = lex.point_span();
+    Span pos = tok.get_pos().filename == "" ? lex.point_span() : Span(tok.get_pos());
     ERROR(pos, E0000, "Unexpected token " << tok);
 }
 ParseError::Unexpected::Unexpected(const TokenStream& lex, const Token& tok, Token exp)//:
 //    m_tok( mv$(tok) )
 {
-    Span pos = tok.get_pos();
-    if(pos.filename == "")
-        pos = lex.point_span();
+    Span pos = tok.get_pos().filename == "" ? lex.point_span() : Span(tok.get_pos());
     ERROR(pos, E0000, "Unexpected token " << tok << ", expected " << exp);
 }
 ParseError::Unexpected::Unexpected(const TokenStream& lex, const Token& tok, ::std::vector<eTokenType> exp)
 {
-    Span pos = tok.get_pos();
-    if(pos.filename == "")
-        pos = lex.point_span();
+    Span pos = tok.get_pos().filename == "" ? lex.point_span() : Span(tok.get_pos());
     ERROR(pos, E0000, "Unexpected token " << tok << ", expected one of " << FMT_CB(os, {
         bool f = true;
         for(auto v: exp) {
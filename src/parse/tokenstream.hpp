@@ -76,7 +76,7 @@ public:
 
 protected:
     virtual Position getPosition() const = 0;
-    virtual ::std::shared_ptr<Span> outerSpan() const { return ::std::shared_ptr<Span>(0); }
+    virtual Span outerSpan() const { return Span(); }
     virtual Token   realGetToken() = 0;
     virtual Ident::Hygiene realGetHygiene() const = 0;
 private:
@@ -9,7 +9,7 @@
 #include <common.hpp>
 
 TTStream::TTStream(Span parent, const TokenTree& input_tt):
-    m_parent_span( new Span(mv$(parent)) )
+    m_parent_span( mv$(parent) )
 {
     DEBUG("input_tt = [" << input_tt << "]");
     m_stack.push_back( ::std::make_pair(0, &input_tt) );
@@ -67,7 +67,7 @@ Ident::Hygiene TTStream::realGetHygiene() const
 
 TTStreamO::TTStreamO(Span parent, TokenTree input_tt):
     m_input_tt( mv$(input_tt) ),
-    m_parent_span( new Span(mv$(parent)) )
+    m_parent_span( mv$(parent) )
 {
     m_stack.push_back( ::std::make_pair(0, nullptr) );
 }
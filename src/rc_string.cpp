@@ -10,16 +10,18 @@
 #include <string>
 #include <iostream>
 #include <algorithm>    // std::max
+#include <new>  // placement new
+#include <mutex>
+#include <unordered_map>
 
 RcString::RcString(const char* s, size_t len):
     m_ptr(nullptr)
 {
     if( len > 0 )
     {
-        m_ptr = new unsigned int[2 + (len+1 + sizeof(unsigned int)-1) / sizeof(unsigned int)];
-        m_ptr[0] = 1;
-        m_ptr[1] = static_cast<unsigned>(len);
-        char* data_mut = reinterpret_cast<char*>(m_ptr + 2);
+        assert(len < INTERNED_FLAG);
+        m_ptr = new (new char[sizeof(Header) + len+1]) Header(static_cast<unsigned>(len));
+        char* data_mut = m_ptr->data();
         for(unsigned int j = 0; j < len; j ++ )
             data_mut[j] = s[j];
         data_mut[len] = '\0';
@@ -31,11 +33,11 @@ RcString::~RcString()
 {
     if(m_ptr)
     {
-        *m_ptr -= 1;
         //::std::cout << "RcString(" << m_ptr << " \"" << *this << "\") - " << *m_ptr << " refs left (drop)" << ::std::endl;
-        if( *m_ptr == 0 )
+        if( dec_ref(m_ptr) )
         {
-            delete[] m_ptr;
+            m_ptr->~Header();
+            delete[] reinterpret_cast<char*>(m_ptr);
             m_ptr = nullptr;
         }
     }
@@ -81,46 +83,54 @@ Ordering RcString::ord(const char* s) const
 }
 
 
-::std::set<RcString>    RcString_interned_strings;
-
-RcString RcString::new_interned(const ::std::string& s)
-{
-#if 0
-    auto it = RcString_interned_strings.find(s);
-    if( it == RcString_interned_strings.end() )
+namespace {
+    // http://www.cse.yorku.ca/~oz/hash.html "djb2"
+    size_t hash_bytes(const char* s, size_t len)
     {
-        it = RcString_interned_strings.insert(RcString(s)).first;
+        size_t h = 5381;
+        for(size_t i = 0; i < len; i ++) {
+            h = h * 33 + (unsigned)s[i];
+        }
+        return h;
     }
-    return *it;
-#else
-    // TODO: interning flag, so comparisons can just be a pointer comparison
-    // - Only want to set this flag on the cached instance
-    return *RcString_interned_strings.insert(RcString(s)).first;
-#endif
+
+    // Keyed on the hash, so lookups don't need to allocate
+    ::std::unordered_multimap<size_t, RcString>    RcString_interned_strings;
+    ::std::mutex RcString_interned_lock;
 }
-RcString RcString::new_interned(const char* s)
+
+/// Look up (or add) a string in the intern table, with `RcString_interned_lock` held
+RcString RcString::new_interned_locked(const char* s, size_t len)
 {
-#if 0
-    auto it = RcString_interned_strings.find(s);
-    if( it == RcString_interned_strings.end() )
+    if( len == 0 )
+        return RcString();
+    auto h = hash_bytes(s, len);
+    auto range = RcString_interned_strings.equal_range(h);
+    for(auto it = range.first; it != range.second; ++it)
     {
-        it = RcString_interned_strings.insert(RcString(s)).first;
+        if( it->second.size() == len && memcmp(it->second.c_str(), s, len) == 0 )
+            return it->second;
     }
-    return *it;
-#else
-    // TODO: interning flag, so comparisons can just be a pointer comparison
-    // - Only want to set this flag on the cached instance
-    return *RcString_interned_strings.insert(RcString(s)).first;
-#endif
+    RcString    rv(s, len);
+    rv.m_ptr->size |= INTERNED_FLAG;
+    return RcString_interned_strings.insert(::std::make_pair(h, mv$(rv)))->second;
+}
+RcString RcString::new_interned(const char* s, size_t len)
+{
+    ::std::lock_guard< ::std::mutex>    lh { RcString_interned_lock };
+    return new_interned_locked(s, len);
+}
+::std::vector<RcString> RcString::new_interned_list(const ::std::vector<::std::string>& strings)
+{
+    ::std::vector<RcString> rv;
+    rv.reserve(strings.size());
+    ::std::lock_guard< ::std::mutex>    lh { RcString_interned_lock };
+    for(const auto& s : strings)
+        rv.push_back( new_interned_locked(s.data(), s.size()) );
+    return rv;
 }
 
 size_t std::hash<RcString>::operator()(const RcString& s) const noexcept
 {
-    // http://www.cse.yorku.ca/~oz/hash.html "djb2"
-    size_t h = 5381;
-    for(auto c : s) {
-        h = h * 33 + (unsigned)c;
-    }
-    return h;
-    //return hash<std::string_view>(s.c_str(), s.size());
+    return hash_bytes(s.c_str(), s.size());
 }
@@ -7,49 +7,150 @@
  */
 #include <functional>
 #include <iostream>
+#include <sstream>
 #include <span.hpp>
 #include <parse/lex.hpp>
 #include <common.hpp>
+#include <atomic>
+#include <mutex>
 
+namespace {
+    // The source map is an append-only table of chunks, so entries never move and can be read without locking
+    const unsigned SPAN_CHUNK_BITS = 12;
+    const size_t SPAN_CHUNK_SIZE = 1 << SPAN_CHUNK_BITS;
+    const size_t SPAN_MAX_CHUNKS = size_t(1) << (32 - SPAN_CHUNK_BITS);
+
+    ::std::atomic<SpanData*>    s_span_chunks[SPAN_MAX_CHUNKS];
+    ::std::mutex    s_span_lock;
+    uint32_t    s_span_count = 1;   // Index 0 is the empty span
+
+    /// Recently added entries, indexed by a hash of their location (the same location is often re-spanned, e.g. by
+    /// each pass that looks at a node). Only one entry is checked per lookup, so not every duplicate is found, but
+    /// this has a fixed size - a full index would cost more memory than the duplicates it removes.
+    const unsigned SPAN_DEDUP_BITS = 16;
+    uint32_t    s_span_dedup[1 << SPAN_DEDUP_BITS];
+    size_t  s_span_dedup_hits = 0;
+
+    uint32_t add_span(RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs, const Span& outer_span)
+    {
+        ::std::lock_guard< ::std::mutex>    lh { s_span_lock };
+        if( s_span_count == UINT32_MAX ) {
+            ::std::cerr << "Too many spans" << ::std::endl;
+            abort();
+        }
+        uint64_t hash = ::std::hash<RcString>()(filename);
+        for(uint64_t v : { start_line, start_ofs, end_line, end_ofs, outer_span.m_idx })
+            hash = hash * 31 + v;
+        auto& dedup_slot = s_span_dedup[(hash * 0x9E3779B97F4A7C15) >> (64 - SPAN_DEDUP_BITS)];
+        if( dedup_slot != 0 )
+        {
+            const auto& e = s_span_chunks[dedup_slot >> SPAN_CHUNK_BITS].load(::std::memory_order_relaxed)[dedup_slot & (SPAN_CHUNK_SIZE-1)];
+            if( e.start_line == start_line && e.start_ofs == start_ofs && e.end_line == end_line && e.end_ofs == end_ofs
+                && e.outer_span.m_idx == outer_span.m_idx && e.filename == filename )
+            {
+                s_span_dedup_hits += 1;
+                return dedup_slot;
+            }
+        }
+
+        auto idx = s_span_count;
+        auto* chunk = s_span_chunks[idx >> SPAN_CHUNK_BITS].load(::std::memory_order_relaxed);
+        if( !chunk ) {
+            chunk = new SpanData[SPAN_CHUNK_SIZE];
+        }
+        auto& ent = chunk[idx & (SPAN_CHUNK_SIZE-1)];
+        ent.filename = ::std::move(filename);
+        ent.start_line = start_line;
+        ent.start_ofs = start_ofs;
+        ent.end_line = end_line;
+        ent.end_ofs = end_ofs;
+        ent.outer_span = outer_span;
+        s_span_chunks[idx >> SPAN_CHUNK_BITS].store(chunk, ::std::memory_order_release);
+        dedup_slot = idx;
+        s_span_count += 1;
+        return idx;
+    }
+}
+
+Span::Span(RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs):
+    m_idx( add_span(::std::move(filename), start_line, start_ofs, end_line, end_ofs, Span()) )
+{
+}
+Span::Span(const Span& outer_span, RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs):
+    m_idx( add_span(::std::move(filename), start_line, start_ofs, end_line, end_ofs, outer_span) )
+{
+}
 Span::Span(const Position& pos):
-    outer_span(),
-    filename(pos.filename),
-    start_line(pos.line),
-    start_ofs(pos.ofs),
-    end_line(pos.line),
-    end_ofs(pos.ofs)
+    Span(pos.filename, pos.line, pos.ofs, pos.line, pos.ofs)
+{
+}
+Span::Span(const Span& outer_span, const Position& pos):
+    Span(outer_span, pos.filename, pos.line, pos.ofs, pos.line, pos.ofs)
+{
+}
+const SpanData& Span::data() const
+{
+    static const SpanData   empty { RcString(), 0,0, 0,0, Span() };
+    if( m_idx == 0 )
+        return empty;
+    return s_span_chunks[m_idx >> SPAN_CHUNK_BITS].load(::std::memory_order_acquire)[m_idx & (SPAN_CHUNK_SIZE-1)];
+}
+Span Span::outer_span() const
 {
+    return data().outer_span;
 }
-Span::Span():
-    outer_span(),
-    filename(""),
-    start_line(0), start_ofs(0),
-    end_line(0), end_ofs(0) // */
+void Span::get_stats(::std::vector< ::std::pair<const char*, size_t> >& out)
 {
-    //DEBUG("Empty span");
-    //filename = FMT(":" << __builtin_return_address(0));
+    ::std::lock_guard< ::std::mutex>    lh { s_span_lock };
+    size_t n_chunks = (s_span_count + SPAN_CHUNK_SIZE-1) >> SPAN_CHUNK_BITS;
+    out.push_back(::std::make_pair("span_entries", size_t(s_span_count - 1)));
+    out.push_back(::std::make_pair("span_map_bytes", n_chunks * SPAN_CHUNK_SIZE * sizeof(SpanData)));
+    out.push_back(::std::make_pair("span_dedup_hits", s_span_dedup_hits));
 }
 
 namespace {
+    // Set while a `SpanMessageCapture` is active on this thread
+    thread_local ::std::string* s_message_capture = nullptr;
+
     void print_span_message(const Span& sp, ::std::function<void(::std::ostream&)> tag, ::std::function<void(::std::ostream&)> msg)
     {
-        auto& sink = ::std::cerr;
-        sink << sp.filename << ":" << sp.start_line << ": ";
+        ::std::ostringstream    ss;
+        auto& sink = (s_message_capture ? static_cast<::std::ostream&>(ss) : ::std::cerr);
+        sink << sp << ": ";
         tag(sink);
         sink << ":";
         msg(sink);
         sink << ::std::endl;
-        const auto* parent = sp.outer_span.get();
-        while(parent)
+        for(auto parent = sp.outer_span(); !parent.is_empty(); parent = parent.outer_span())
+        {
+            sink << parent << ": note: From here" << ::std::endl;
+        }
+        if( s_message_capture )
         {
-            sink << parent->filename << ":" << parent->start_line << ": note: From here" << ::std::endl;
-            parent = parent->outer_span.get();
+            *s_message_capture += ss.str();
         }
     }
+    void fatal_span_message()
+    {
+        if( s_message_capture )
+            throw SpanMessageCapture::Fatal();
+        SpanMessageCapture::exit_fatal();
+    }
 }
-void Span::bug(::std::function<void(::std::ostream&)> msg) const
+
+SpanMessageCapture::SpanMessageCapture(::std::string& out):
+    m_saved(s_message_capture)
 {
-    print_span_message(*this, [](auto& os){os << "BUG";}, msg);
+    s_message_capture = &out;
+}
+SpanMessageCapture::~SpanMessageCapture()
+{
+    s_message_capture = m_saved;
+}
+void SpanMessageCapture::exit_fatal()
+{
+    // Keep the trace leading up to the failure (worker threads buffer theirs until the task completes)
+    debug_flush_buffered();
 #ifndef _WIN32
     abort();
 #else
@@ -57,13 +158,15 @@ void Span::bug(::std::function<void(::std::ostream&)> msg) const
 #endif
 }
 
+void Span::bug(::std::function<void(::std::ostream&)> msg) const
+{
+    print_span_message(*this, [](auto& os){os << "BUG";}, msg);
+    fatal_span_message();
+}
+
 void Span::error(ErrorType tag, ::std::function<void(::std::ostream&)> msg) const {
     print_span_message(*this, [&](auto& os){os << "error:" << tag;}, msg);
-#ifndef _WIN32
-    abort();
-#else
-    exit(1);
-#endif
+    fatal_span_message();
 }
 void Span::warning(WarningType tag, ::std::function<void(::std::ostream&)> msg) const {
     print_span_message(*this, [&](auto& os){os << "warn:" << tag;}, msg);
@@ -74,6 +177,7 @@ void Span::note(::std::function<void(::std::ostream&)> msg) const {
 
 ::std::ostream& operator<<(::std::ostream& os, const Span& sp)
 {
-    os << sp.filename << ":" << sp.start_line;
+    const auto& d = sp.data();
+    os << d.filename << ":" << d.start_line;
     return os;
 }
@@ -0,0 +1,225 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * thread_pool.cpp
+ * - Work-stealing thread pool
+ */
+#include <thread_pool.hpp>
+#include <debug.hpp>
+#include <debug_inner.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+unsigned int g_num_threads = 1;
+
+struct ThreadPool::Inner
+{
+    /// Per-worker range of indexes still to be processed
+    /// - The owner takes from the front, thieves take the back half.
+    struct Queue
+    {
+        ::std::mutex    lock;
+        size_t  next = 0;
+        size_t  end = 0;
+    };
+    ::std::vector< ::std::unique_ptr<Queue> >  queues;
+    ::std::vector< ::std::thread>  threads;
+
+    ::std::mutex    lock;
+    ::std::condition_variable   cv_start;
+    ::std::condition_variable   cv_done;
+    unsigned    generation = 0;
+    unsigned    num_running = 0;
+    bool    shutdown = false;
+
+    const ::std::function<void(size_t)>*    cb = nullptr;
+    ::std::atomic<bool> failed { false };
+    ::std::exception_ptr    error;
+
+    bool take_local(size_t worker, size_t& out_idx)
+    {
+        auto& q = *queues[worker];
+        ::std::lock_guard< ::std::mutex>    lh { q.lock };
+        if( q.next == q.end )
+            return false;
+        out_idx = q.next ++;
+        return true;
+    }
+    bool steal(size_t worker, size_t& out_idx)
+    {
+        for(size_t ofs = 1; ofs < queues.size(); ofs ++)
+        {
+            auto& victim = *queues[(worker + ofs) % queues.size()];
+            size_t  first, last;
+            {
+                ::std::lock_guard< ::std::mutex>    lh { victim.lock };
+                if( victim.next == victim.end )
+                    continue ;
+                last = victim.end;
+                first = victim.next + (victim.end - victim.next) / 2;
+                victim.end = first;
+            }
+            // Only the owner adds to its own queue, and it's empty here - so this can't race with another steal into it
+            auto& q = *queues[worker];
+            ::std::lock_guard< ::std::mutex>    lh { q.lock };
+            q.next = first + 1;
+            q.end = last;
+            out_idx = first;
+            return true;
+        }
+        return false;
+    }
+
+    void run_worker(size_t worker)
+    {
+        size_t  idx;
+        while( !failed && (take_local(worker, idx) || steal(worker, idx)) )
+        {
+            try
+            {
+                (*cb)(idx);
+            }
+            catch(...)
+            {
+                ::std::lock_guard< ::std::mutex>    lh { lock };
+                if( !error )
+                    error = ::std::current_exception();
+                failed = true;
+            }
+        }
+    }
+
+    void thread_body(size_t worker)
+    {
+        unsigned seen_generation = 0;
+        for(;;)
+        {
+            {
+                ::std::unique_lock< ::std::mutex>   lh { lock };
+                cv_start.wait(lh, [&]{ return shutdown || generation != seen_generation; });
+                if( shutdown )
+                    return ;
+                seen_generation = generation;
+            }
+
+            run_worker(worker);
+
+            {
+                ::std::lock_guard< ::std::mutex>    lh { lock };
+                num_running -= 1;
+                if( num_running == 0 )
+                    cv_done.notify_all();
+            }
+        }
+    }
+};
+
+ThreadPool::ThreadPool(unsigned int num_threads):
+    m_inner(new Inner)
+{
+    if( num_threads == 0 )
+        num_threads = 1;
+    for(unsigned int i = 0; i < num_threads; i ++)
+        m_inner->queues.push_back( ::std::unique_ptr<Inner::Queue>(new Inner::Queue) );
+    // Worker 0 is the thread calling `for_each_index`
+    for(unsigned int i = 1; i < num_threads; i ++)
+    {
+        auto* inner = m_inner.get();
+        m_inner->threads.push_back(::std::thread([inner,i](){ inner->thread_body(i); }));
+    }
+}
+ThreadPool::~ThreadPool()
+{
+    {
+        ::std::lock_guard< ::std::mutex>    lh { m_inner->lock };
+        m_inner->shutdown = true;
+    }
+    m_inner->cv_start.notify_all();
+    for(auto& t : m_inner->threads)
+        t.join();
+}
+
+unsigned int ThreadPool::num_threads() const
+{
+    return m_inner->queues.size();
+}
+
+void ThreadPool::for_each_index(size_t count, ::std::function<void(size_t)> cb)
+{
+    auto& inner = *m_inner;
+    if( inner.threads.empty() || count <= 1 )
+    {
+        for(size_t i = 0; i < count; i ++)
+            cb(i);
+        return ;
+    }
+
+    // Each task runs with the caller's debug state, with trace output buffered per-task
+    // - Buffers are written out in index order afterwards, so the log matches a serial run.
+    auto debug_state = DebugThreadContext::capture();
+    ::std::vector< ::std::string>   debug_logs( debug_state.enabled ? count : 0 );
+    ::std::function<void(size_t)>   task_cb = [&](size_t idx) {
+        if( debug_state.enabled )
+        {
+            ::std::ostringstream    ss;
+            DebugThreadContext  ctx(debug_state, &ss);
+            try
+            {
+                cb(idx);
+            }
+            catch(...)
+            {
+                debug_logs[idx] = ss.str();
+                throw;
+            }
+            debug_logs[idx] = ss.str();
+        }
+        else
+        {
+            DebugThreadContext  ctx(debug_state, nullptr);
+            cb(idx);
+        }
+        };
+
+    // Hand each worker an even share of the range (contiguous, to keep related items together)
+    size_t n_queues = inner.queues.size();
+    for(size_t i = 0; i < n_queues; i ++)
+    {
+        inner.queues[i]->next = count * i / n_queues;
+        inner.queues[i]->end = count * (i+1) / n_queues;
+    }
+    inner.cb = &task_cb;
+    inner.failed = false;
+    inner.error = nullptr;
+    {
+        ::std::lock_guard< ::std::mutex>    lh { inner.lock };
+        inner.generation += 1;
+        inner.num_running = inner.threads.size();
+    }
+    inner.cv_start.notify_all();
+
+    inner.run_worker(0);
+
+    {
+        ::std::unique_lock< ::std::mutex>   lh { inner.lock };
+        inner.cv_done.wait(lh, [&]{ return inner.num_running == 0; });
+    }
+    inner.cb = nullptr;
+
+    for(const auto& log : debug_logs)
+        debug_stream() << log;
+    debug_stream().flush();
+
+    if( inner.error )
+    {
+        auto e = inner.error;
+        inner.error = nullptr;
+        ::std::rethrow_exception(e);
+    }
+}
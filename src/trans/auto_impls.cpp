@@ -13,7 +13,9 @@
 #include <mir/mir.hpp>
 #include <hir_typeck/common.hpp>    // monomorph
 #include <hir_typeck/static.hpp>    // StaticTraitResolve
+#include <hir_typeck/impl_cache.hpp>    // ImplQueryCache
 #include <deque>
+#include <unordered_set>
 #include <algorithm>    // find_if
 
 namespace {
@@ -23,7 +25,7 @@ namespace {
         StaticTraitResolve resolve;
         const TransList& trans_list;
         ::std::deque<::HIR::TypeRef>    todo_list;
-        ::std::set<::HIR::TypeRef>  done_list;
+        ::std::unordered_set<::HIR::TypeRef>  done_list;
 
         ::HIR::SimplePath  lang_Clone;
 
@@ -201,6 +203,7 @@ void Trans_AutoImpl_Clone(State& state, ::HIR::TypeRef ty)
     impl.m_methods.insert(::std::make_pair( RcString::new_interned("clone"), ::HIR::TraitImpl::ImplEnt< ::HIR::Function> { false, ::std::move(fcn) } ));
 
     // Add impl to the crate
+    ImplQueryCache::clear_all();
     auto& list = state.crate.m_trait_impls[state.lang_Clone].get_list_for_type_mut(impl.m_type);
     list.push_back( box$(impl) );
 }
@@ -228,6 +231,7 @@ void Trans_AutoImpls(::HIR::Crate& crate, TransList& trans_list)
     }
 
     auto impl_list_it = crate.m_trait_impls.find(state.lang_Clone);
+    // NOTE: Iteration order doesn't matter, `add_function` sorts by path
     for(const auto& ty : state.done_list)
     {
         assert(impl_list_it != crate.m_trait_impls.end());
@@ -26,7 +26,7 @@ void Trans_Codegen(const ::std::string& outfile, CodegenOutput out_ty, const Tra
     }
     else if( opt.mode == "c" )
     {
-        codegen = Trans_Codegen_GetGeneratorC(crate, outfile);
+        codegen = Trans_Codegen_GetGeneratorC(crate, outfile, opt.codegen_units);
     }
     else
     {
@@ -64,9 +64,16 @@ void Trans_Codegen(const ::std::string& outfile, CodegenOutput out_ty, const Tra
             codegen->emit_type(ty.first);
         }
     }
-    for(const auto& ty : list.m_typeids)
     {
-        codegen->emit_type_id(ty);
+        ::std::vector<const ::HIR::TypeRef*> typeids;
+        typeids.reserve(list.m_typeids.size());
+        for(const auto& ty : list.m_typeids)
+            typeids.push_back(&ty);
+        ::std::sort(typeids.begin(), typeids.end(), [](const ::HIR::TypeRef* a, const ::HIR::TypeRef* b){ return *a < *b; });
+        for(const auto* ty : typeids)
+        {
+            codegen->emit_type_id(*ty);
+        }
     }
     // Emit required constructor methods (and other wrappers)
     for(const auto& path : list.m_constructors)
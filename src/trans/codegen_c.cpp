@@ -10,6 +10,9 @@
 #include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <sstream>
+#include <unordered_set>
+#include <thread_pool.hpp>
 #include <hir/hir.hpp>
 #include <mir/mir.hpp>
 #include <hir_typeck/static.hpp>
@@ -94,6 +97,7 @@ namespace {
     };
 }
 
+
 ::std::ostream& operator<<(::std::ostream& os, const FmtShell& x)
 {
     if( x.is_win )
@@ -132,6 +136,34 @@ namespace {
     return os;
 }
 
+namespace {
+    ::std::string get_file_name(const ::std::string& path)
+    {
+        auto pos = path.find_last_of("/\\");
+        return pos == ::std::string::npos ? path : path.substr(pos+1);
+    }
+    void fmt_command(::std::ostream& os, const ::std::vector<const char*>& args, bool is_windows)
+    {
+        if (is_windows)
+        {
+            os << "echo \"\" & ";
+        }
+        for(const auto& arg : args)
+        {
+            if(strcmp(arg, "&") == 0 && is_windows) {
+                os << "&";
+            }
+            else {
+                if( is_windows && strchr(arg, ' ') == nullptr ) {
+                    os << arg << " ";
+                    continue ;
+                }
+                os << "\"" << FmtShell(arg, is_windows) << "\" ";
+            }
+        }
+    }
+}
+
 namespace {
     struct MsvcDetection
     {
@@ -181,7 +213,16 @@ namespace {
         ::std::string   m_outfile_path;
         ::std::string   m_outfile_path_c;
 
-        ::std::ofstream m_of;
+        // Output is split into a shared header (types, prototypes, glue) and N code files when `codegen_units > 1`
+        // - `m_of` is redirected between these files as the emission moves between sections.
+        ::std::string   m_outfile_path_h;
+        ::std::ofstream m_file_header;
+        ::std::vector< ::std::string>   m_unit_paths;
+        ::std::vector< ::std::ofstream> m_unit_files;
+        /// Approximate amount of code (in MIR statements) emitted to each unit, used to balance the split
+        ::std::vector<size_t>   m_unit_sizes;
+
+        ::std::ostream  m_of;
         const ::MIR::TypeResolve* m_mir_res;
 
         Compiler    m_compiler = Compiler::Gcc;
@@ -191,14 +232,16 @@ namespace {
         } m_options;
 
         ::std::vector< ::std::pair< ::HIR::GenericPath, const ::HIR::Struct*> >   m_box_glue_todo;
-        ::std::set< ::HIR::TypeRef> m_emitted_fn_types;
+        ::std::unordered_set< ::HIR::TypeRef> m_emitted_fn_types;
+        /// Output that was selected before `begin_glue_def` moved it to the first unit
+        ::std::streambuf*   m_glue_prev_buf = nullptr;
     public:
-        CodeGenerator_C(const ::HIR::Crate& crate, const ::std::string& outfile):
+        CodeGenerator_C(const ::HIR::Crate& crate, const ::std::string& outfile, unsigned int codegen_units):
             m_crate(crate),
             m_resolve(crate),
             m_outfile_path(outfile),
             m_outfile_path_c(outfile + ".c"),
-            m_of(m_outfile_path_c)
+            m_of(nullptr)
         {
             m_options.emulated_i128 = Target_GetCurSpec().m_backend_c.m_emulated_i128;
             switch(Target_GetCurSpec().m_backend_c.m_codegen_mode)
@@ -221,6 +264,37 @@ namespace {
                 break;
             }
 
+            if( codegen_units > 1 && m_compiler != Compiler::Gcc )
+            {
+                WARNING(Span(), W0000, "Multiple codegen units are only supported with the GCC backend, using one");
+                codegen_units = 1;
+            }
+            if( codegen_units > 1 )
+            {
+                m_outfile_path_h = outfile + ".h";
+                m_file_header.open(m_outfile_path_h);
+                for(unsigned int i = 0; i < codegen_units; i ++)
+                {
+                    m_unit_paths.push_back( i == 0 ? m_outfile_path_c : FMT(outfile << "." << i << ".c") );
+                    m_unit_files.push_back( ::std::ofstream(m_unit_paths.back()) );
+                    m_unit_files.back()
+                        << "/*\n"
+                        << " * AUTOGENERATED by mrustc - codegen unit " << i << "\n"
+                        << " */\n"
+                        << "#include \"" << get_file_name(m_outfile_path_h) << "\"\n"
+                        ;
+                }
+                m_unit_sizes.resize(codegen_units);
+                m_of.rdbuf(m_file_header.rdbuf());
+            }
+            else
+            {
+                m_unit_paths.push_back(m_outfile_path_c);
+                m_unit_files.push_back( ::std::ofstream(m_outfile_path_c) );
+                m_unit_sizes.resize(1);
+                m_of.rdbuf(m_unit_files[0].rdbuf());
+            }
+
             m_of
                 << "/*\n"
                 << " * AUTOGENERATED by mrustc\n"
@@ -623,13 +697,62 @@ namespace {
 
         ~CodeGenerator_C() {}
 
+        bool is_split() const {
+            return m_unit_files.size() > 1;
+        }
+        /// Direct output to the shared header (the only file when not split)
+        void select_header() {
+            m_of.rdbuf( is_split() ? m_file_header.rdbuf() : m_unit_files[0].rdbuf() );
+        }
+        /// Direct output to the given codegen unit
+        void select_unit(size_t idx) {
+            m_of.rdbuf( m_unit_files.at(idx).rdbuf() );
+        }
+        /// Linkage for functions defined in every crate that uses them (e.g. monomorphised generics from other crates)
+        /// - Usually these are `static`, but that doesn't work when the definition can be in a different C file
+        const char* extern_def_linkage() const {
+            return is_split() ? "__attribute__((weak)) " : "static ";
+        }
+        /// Start the definition of a generated helper (drop glue, constructors, shims) by emitting its signature
+        /// - These are `static` in a single file. When split they're defined once in the first unit (weak, as other crates
+        ///   emit the same glue) with a prototype in the header, instead of a copy in every unit.
+        /// - The caller emits the body, then calls `end_glue_def`
+        template<typename Cb>
+        void begin_glue_def(Cb emit_signature)
+        {
+            if( !is_split() )
+            {
+                m_of << "static ";
+                emit_signature();
+                return ;
+            }
+            ::std::stringstream sig;
+            m_glue_prev_buf = m_of.rdbuf(sig.rdbuf());
+            emit_signature();
+            m_of.rdbuf(m_glue_prev_buf);
+            m_of << sig.str() << ";\n";
+            select_unit(0);
+            m_of << "__attribute__((weak)) " << sig.str();
+        }
+        void end_glue_def()
+        {
+            if( is_split() )
+            {
+                m_of.rdbuf(m_glue_prev_buf);
+                m_glue_prev_buf = nullptr;
+            }
+        }
+
         void finalise(const TransOptions& opt, CodegenOutput out_ty, const ::std::string& hir_file) override
         {
             // Emit box drop glue after everything else to avoid definition ordering issues
+            // - The prototype goes in the header (alongside the other drop glue)
+            select_header();
             for(auto& e : m_box_glue_todo)
             {
                 emit_box_drop_glue( mv$(e.first), *e.second );
             }
+            select_unit(0);
 
             const bool create_shims = (out_ty == CodegenOutput::Executable);
 
@@ -756,7 +879,9 @@ namespace {
             }
 
             m_of.flush();
-            m_of.close();
+            m_file_header.close();
+            for(auto& f : m_unit_files)
+                f.close();
 
             ::std::vector<const char*> link_dirs;
             auto add_link_dir = [&link_dirs](const char* d) {
@@ -779,6 +904,9 @@ namespace {
 
             // Execute $CC with the required libraries
             StringList  args;
+            // - Per-unit compile commands (only used when split)
+            ::std::vector< ::std::string>   unit_objs;
+            ::std::vector< ::std::string>   unit_cmds;
 #ifdef _WIN32
             bool is_windows = true;
 #else
@@ -826,6 +954,31 @@ namespace {
                     args.push_back("-g");
                 }
                 args.push_back("-fPIC");
+                if( is_split() )
+                {
+                    // Compile each unit to its own object (run in parallel below), then link/merge those objects
+                    for(const auto& path : m_unit_paths)
+                    {
+                        unit_objs.push_back(path + ".o");
+                    }
+                    for(size_t i = 0; i < m_unit_paths.size(); i ++)
+                    {
+                        auto unit_args = args.get_vec();
+                        unit_args.push_back("-c");
+                        unit_args.push_back("-o");
+                        unit_args.push_back(unit_objs[i].c_str());
+                        unit_args.push_back(m_unit_paths[i].c_str());
+                        ::std::stringstream unit_ss;
+                        fmt_command(unit_ss, unit_args, is_windows);
+                        unit_cmds.push_back(unit_ss.str());
+                    }
+                    if( out_ty == CodegenOutput::Object || out_ty == CodegenOutput::StaticLibrary )
+                    {
+                        // Consumers expect a single object per crate, so merge with a relocatable link
+                        args.push_back("-r");
+                        args.push_back("-nostdlib");
+                    }
+                }
                 args.push_back("-o");
                 switch(out_ty)
                 {
@@ -838,7 +991,15 @@ namespace {
                     args.push_back(m_outfile_path+".o");
                     break;
                 }
-                args.push_back(m_outfile_path_c.c_str());
+                if( is_split() )
+                {
+                    for(const auto& path : unit_objs)
+                        args.push_back(path.c_str());
+                }
+                else
+                {
+                    args.push_back(m_outfile_path_c.c_str());
+                }
                 switch(out_ty)
                 {
                 case CodegenOutput::DynamicLibrary:
@@ -912,7 +1073,10 @@ namespace {
                     break;
                 case CodegenOutput::StaticLibrary:
                 case CodegenOutput::Object:
-                    args.push_back("-c");
+                    if( !is_split() )
+                    {
+                        args.push_back("-c");
+                    }
                     break;
                 }
                 break;
@@ -999,44 +1163,51 @@ namespace {
             }
 
             ::std::stringstream cmd_ss;
-            if (is_windows)
-            {
-                cmd_ss << "echo \"\" & ";
-            }
-            for(const auto& arg : args.get_vec())
+            fmt_command(cmd_ss, args.get_vec(), is_windows);
+            //DEBUG("- " << cmd_ss.str());
+            for(const auto& cmd : unit_cmds)
             {
-                if(strcmp(arg, "&") == 0 && is_windows) {
-                    cmd_ss << "&";
-                }
-                else {
-                    if( is_windows && strchr(arg, ' ') == nullptr ) {
-                        cmd_ss << arg << " ";
-                        continue ;
-                    }
-                    cmd_ss << "\"" << FmtShell(arg, is_windows) << "\" ";
-                }
+                ::std::cout << "Running comamnd - " << cmd << ::std::endl;
             }
-            //DEBUG("- " << cmd_ss.str());
             ::std::cout << "Running comamnd - " << cmd_ss.str() << ::std::endl;
             if( opt.build_command_file != "" )
             {
+                ::std::ofstream of(opt.build_command_file);
+                for(const auto& cmd : unit_cmds)
+                {
+                    ::std::cerr << "INVOKE CC: " << cmd << ::std::endl;
+                    of << cmd << ::std::endl;
+                }
                 ::std::cerr << "INVOKE CC: " << cmd_ss.str() << ::std::endl;
-                ::std::ofstream(opt.build_command_file) << cmd_ss.str() << ::std::endl;
+                of << cmd_ss.str() << ::std::endl;
             }
             else
             {
-                int ec = system(cmd_ss.str().c_str());
-                if( ec == -1 )
-                {
-                    ::std::cerr << "C Compiler failed to execute (system returned -1)" << ::std::endl;
-                    perror("system");
-                    exit(1);
-                }
-                else if( ec != 0 )
+                auto check_ec = [](int ec) {
+                    if( ec == -1 )
+                    {
+                        ::std::cerr << "C Compiler failed to execute (system returned -1)" << ::std::endl;
+                        perror("system");
+                        exit(1);
+                    }
+                    else if( ec != 0 )
+                    {
+                        ::std::cerr << "C Compiler failed to execute - error code " << ec << ::std::endl;
+                        exit(1);
+                    }
+                    };
+                // Compile the units in parallel (each is an independent compiler process), at most `-Z threads` at a time
+                if( !unit_cmds.empty() )
                 {
-                    ::std::cerr << "C Compiler failed to execute - error code " << ec << ::std::endl;
-                    exit(1);
+                    ::std::vector<int>  unit_ecs(unit_cmds.size());
+                    ThreadPool  pool;
+                    pool.for_each_index(unit_cmds.size(), [&](size_t i) {
+                        unit_ecs[i] = system(unit_cmds[i].c_str());
+                        });
+                    for(int ec : unit_ecs)
+                        check_ec(ec);
                 }
+                check_ec( system(cmd_ss.str().c_str()) );
             }
 
             // HACK! Static libraries aren't implemented properly yet, just touch the output file
@@ -1094,11 +1265,13 @@ namespace {
             ::MIR::Function empty_fcn;
             ::MIR::TypeResolve  mir_res { sp, m_resolve, FMT_CB(ss, ss << drop_glue_path;), struct_ty_ptr, args, empty_fcn };
             m_mir_res = &mir_res;
-            m_of << "static void " << Trans_Mangle(drop_glue_path) << "(struct s_" << Trans_Mangle(p) << "* rv) {\n";
+            begin_glue_def([&](){ m_of << "void " << Trans_Mangle(drop_glue_path) << "(struct s_" << Trans_Mangle(p) << "* rv)"; });
+            m_of << " {\n";
 
             emit_box_drop(1, *ity, ::MIR::LValue::new_Deref(::MIR::LValue::new_Return()), /*run_destructor=*/true);
 
             m_of << "}\n";
+            end_glue_def();
             m_mir_res = nullptr;
         }
 
@@ -1156,7 +1329,7 @@ namespace {
         }
         void emit_type_fn(const ::HIR::TypeRef& ty)
         {
-            if( m_emitted_fn_types.count(ty) ) {
+            if( m_emitted_fn_types.count(ty) != 0 ) {
                 return ;
             }
             m_emitted_fn_types.insert(ty.clone());
@@ -1239,7 +1412,8 @@ namespace {
                 auto ty_ptr = ::HIR::TypeRef::new_pointer(::HIR::BorrowType::Owned, ty.clone());
                 ::MIR::TypeResolve  mir_res { sp, m_resolve, FMT_CB(ss, ss << drop_glue_path;), ty_ptr, args, empty_fcn };
                 m_mir_res = &mir_res;
-                m_of << "static void " << Trans_Mangle(drop_glue_path) << "("; emit_ctype(ty); m_of << "* rv) {\n";
+                begin_glue_def([&](){ m_of << "void " << Trans_Mangle(drop_glue_path) << "("; emit_ctype(ty); m_of << "* rv)"; });
+                m_of << " {\n";
                 if( m_resolve.type_needs_drop_glue(sp, ty) )
                 {
                     auto self = ::MIR::LValue::new_Deref(::MIR::LValue::new_Return());
@@ -1252,6 +1426,7 @@ namespace {
                     }
                 }
                 m_of << "}\n";
+                end_glue_def();
             )
             else TU_IFLET( ::HIR::TypeRef::Data, ty.m_data, Function, te,
                 emit_type_fn(ty);
@@ -1427,7 +1602,9 @@ namespace {
             if( m_resolve.is_type_owned_box(struct_ty) )
             {
                 m_box_glue_todo.push_back( ::std::make_pair( mv$(struct_ty.m_data.as_Path().path.m_data.as_Generic()), &item ) );
-                m_of << "static void " << Trans_Mangle(drop_glue_path) << "("; emit_ctype(struct_ty_ptr, FMT_CB(ss, ss << "rv";)); m_of << ");\n";
+                if( !is_split() )
+                    m_of << "static ";
+                m_of << "void " << Trans_Mangle(drop_glue_path) << "("; emit_ctype(struct_ty_ptr, FMT_CB(ss, ss << "rv";)); m_of << ");\n";
                 return ;
             }
             else if( item.m_markings.has_drop_impl ) {
@@ -1435,7 +1612,7 @@ namespace {
                 if( p.m_path.m_crate_name != m_crate.m_crate_name )
                 {
                     if( item.m_params.m_types.size() > 0 ) {
-                        m_of << "static ";
+                        m_of << extern_def_linkage();
                     }
                     else {
                         m_of << "extern ";
@@ -1449,7 +1626,8 @@ namespace {
 
             ::MIR::TypeResolve  mir_res { sp, m_resolve, FMT_CB(ss, ss << drop_glue_path;), struct_ty_ptr, args, empty_fcn };
             m_mir_res = &mir_res;
-            m_of << "static void " << Trans_Mangle(drop_glue_path) << "("; emit_ctype(struct_ty_ptr, FMT_CB(ss, ss << "rv";)); m_of << ") {\n";
+            begin_glue_def([&](){ m_of << "void " << Trans_Mangle(drop_glue_path) << "("; emit_ctype(struct_ty_ptr, FMT_CB(ss, ss << "rv";)); m_of << ")"; });
+            m_of << " {\n";
             if( m_resolve.type_needs_drop_glue(sp, item_ty) )
             {
                 // If this type has an impl of Drop, call that impl
@@ -1466,6 +1644,7 @@ namespace {
                 }
             }
             m_of << "}\n";
+            end_glue_def();
             m_mir_res = nullptr;
         }
         void emit_union(const Span& sp, const ::HIR::GenericPath& p, const ::HIR::Union& item) override
@@ -1503,12 +1682,14 @@ namespace {
                 m_of << "void " << Trans_Mangle(drop_impl_path) << "(union u_" << Trans_Mangle(p) << "*rv);\n";
             }
 
-            m_of << "static void " << Trans_Mangle(drop_glue_path) << "(union u_" << Trans_Mangle(p) << "* rv) {\n";
+            begin_glue_def([&](){ m_of << "void " << Trans_Mangle(drop_glue_path) << "(union u_" << Trans_Mangle(p) << "* rv)"; });
+            m_of << " {\n";
             if( item.m_markings.has_drop_impl )
             {
                 m_of << "\t" << Trans_Mangle(drop_impl_path) << "(rv);\n";
             }
             m_of << "}\n";
+            end_glue_def();
         }
 
         void emit_enum_path(const TypeRepr* repr, const TypeRepr::FieldPath& path)
@@ -1692,7 +1873,8 @@ namespace {
                 m_of << "void " << Trans_Mangle(drop_impl_path) << "(struct e_" << Trans_Mangle(p) << "*rv);\n";
             }
 
-            m_of << "static void " << Trans_Mangle(drop_glue_path) << "(struct e_" << Trans_Mangle(p) << "* rv) {\n";
+            begin_glue_def([&](){ m_of << "void " << Trans_Mangle(drop_glue_path) << "(struct e_" << Trans_Mangle(p) << "* rv)"; });
+            m_of << " {\n";
             if( m_resolve.type_needs_drop_glue(sp, item_ty) )
             {
                 // If this type has an impl of Drop, call that impl
@@ -1731,6 +1913,7 @@ namespace {
                 }
             }
             m_of << "}\n";
+            end_glue_def();
             m_mir_res = nullptr;
         }
 
@@ -1765,14 +1948,17 @@ namespace {
             const auto& e = str.m_data.as_Tuple();
 
 
-            m_of << "static struct e_" << Trans_Mangle(p) << " " << Trans_Mangle(path) << "(";
-            for(unsigned int i = 0; i < e.size(); i ++)
-            {
-                if(i != 0)
-                    m_of << ", ";
-                emit_ctype( monomorph(e[i].ent), FMT_CB(ss, ss << "_" << i;) );
-            }
-            m_of << ") {\n";
+            begin_glue_def([&](){
+                m_of << "struct e_" << Trans_Mangle(p) << " " << Trans_Mangle(path) << "(";
+                for(unsigned int i = 0; i < e.size(); i ++)
+                {
+                    if(i != 0)
+                        m_of << ", ";
+                    emit_ctype( monomorph(e[i].ent), FMT_CB(ss, ss << "_" << i;) );
+                }
+                m_of << ")";
+                });
+            m_of << " {\n";
 
             //if( repr->variants.
             m_of << "\tstruct e_" << Trans_Mangle(p) << " rv = {";
@@ -1820,6 +2006,7 @@ namespace {
             m_of << " };\n";
             m_of << "\treturn rv;\n";
             m_of << "}\n";
+            end_glue_def();
             m_mir_res = nullptr;
         }
         void emit_constructor_struct(const Span& sp, const ::HIR::GenericPath& p, const ::HIR::Struct& item) override
@@ -1838,14 +2025,17 @@ namespace {
                 };
             // Crate constructor function
             const auto& e = item.m_data.as_Tuple();
-            m_of << "static struct s_" << Trans_Mangle(p) << " " << Trans_Mangle(p) << "(";
-            for(unsigned int i = 0; i < e.size(); i ++)
-            {
-                if(i != 0)
-                    m_of << ", ";
-                emit_ctype( monomorph(e[i].ent), FMT_CB(ss, ss << "_" << i;) );
-            }
-            m_of << ") {\n";
+            begin_glue_def([&](){
+                m_of << "struct s_" << Trans_Mangle(p) << " " << Trans_Mangle(p) << "(";
+                for(unsigned int i = 0; i < e.size(); i ++)
+                {
+                    if(i != 0)
+                        m_of << ", ";
+                    emit_ctype( monomorph(e[i].ent), FMT_CB(ss, ss << "_" << i;) );
+                }
+                m_of << ")";
+                });
+            m_of << " {\n";
             m_of << "\tstruct s_" << Trans_Mangle(p) << " rv = {";
             bool emitted = false;
             for(unsigned int i = 0; i < e.size(); i ++)
@@ -1865,6 +2055,7 @@ namespace {
             m_of << "\t\t};\n";
             m_of << "\treturn rv;\n";
             m_of << "}\n";
+            end_glue_def();
         }
 
         void emit_static_ext(const ::HIR::Path& p, const ::HIR::Static& item, const Trans_Params& params) override
@@ -1912,6 +2103,9 @@ namespace {
 
             TRACE_FUNCTION_F(p);
             auto type = params.monomorph(m_resolve, item.m_type);
+            // NOTE: When split, this must not be a tentative definition (it's included in every unit)
+            if( is_split() )
+                m_of << "extern ";
             emit_ctype( type, FMT_CB(ss, ss << Trans_Mangle(p);) );
             m_of << ";";
             m_of << "\t// static " << p << " : " << type;
@@ -1926,6 +2120,7 @@ namespace {
             m_mir_res = &top_mir_res;
 
             TRACE_FUNCTION_F(p);
+            select_unit(0);
 
             auto type = params.monomorph(m_resolve, item.m_type);
             emit_ctype( type, FMT_CB(ss, ss << Trans_Mangle(p);) );
@@ -2301,12 +2496,14 @@ namespace {
                     for(const auto& ty : te->m_arg_types)
                         arg_ty.m_data.as_Tuple().push_back( ty.clone() );
 
-                    m_of << "static ";
-                    if( *te->m_rettype == ::HIR::TypeRef::new_unit() )
-                        m_of << "void ";
-                    else
-                        emit_ctype(*te->m_rettype);
-                    m_of << " " << Trans_Mangle(fcn_p) << "("; emit_ctype(type, FMT_CB(ss, ss << "*ptr";)); m_of << ", "; emit_ctype(arg_ty, FMT_CB(ss, ss << "args";)); m_of << ") {\n";
+                    begin_glue_def([&](){
+                        if( *te->m_rettype == ::HIR::TypeRef::new_unit() )
+                            m_of << "void ";
+                        else
+                            emit_ctype(*te->m_rettype);
+                        m_of << " " << Trans_Mangle(fcn_p) << "("; emit_ctype(type, FMT_CB(ss, ss << "*ptr";)); m_of << ", "; emit_ctype(arg_ty, FMT_CB(ss, ss << "args";)); m_of << ")";
+                        });
+                    m_of << " {\n";
                     m_of << "\t";
                     if( *te->m_rettype == ::HIR::TypeRef::new_unit() )
                         ;
@@ -2320,6 +2517,7 @@ namespace {
                         }
                         m_of << ");\n";
                     m_of << "}\n";
+                    end_glue_def();
                 }
             }
 
@@ -2401,10 +2599,10 @@ namespace {
             // For MSVC, make a static wrapper that goes and calls the actual function
             if( item.m_linkage.name.rfind("llvm.", 0) == 0 )
             {
-                m_of << "static ";
-                emit_function_header(p, item, params);
+                begin_glue_def([&](){ emit_function_header(p, item, params); });
                 // TODO: Hand off to compiler-specific intrinsics
                 m_of << " { abort(); }\n";
+                end_glue_def();
                 m_mir_res = nullptr;
                 return ;
             }
@@ -2417,13 +2615,13 @@ namespace {
             {
                 MIR_ASSERT(*m_mir_res, m_compiler == Compiler::Gcc, item.m_linkage.name << " in non-GCC mode");
                 m_of << "// - Magic compiler impl\n";
-                m_of << "static ";
-                emit_function_header(p, item, params);
+                begin_glue_def([&](){ emit_function_header(p, item, params); });
                 m_of << " {\n";
                 m_of << "\tif( !mrustc_panic_target ) abort();\n";
                 m_of << "\tmrustc_panic_value = arg0;\n";
                 m_of << "\tlongjmp(*mrustc_panic_target, 1);\n";
                 m_of << "}\n";
+                end_glue_def();
                 return;
             }
             else
@@ -2461,7 +2659,7 @@ namespace {
             }
             if( is_extern_def )
             {
-                m_of << "static ";
+                m_of << extern_def_linkage();
             }
             emit_function_header(p, item, params);
             m_of << ";\n";
@@ -2482,9 +2680,18 @@ namespace {
             ::MIR::TypeResolve  mir_res { sp, m_resolve, FMT_CB(ss, ss << p;), ret_type, arg_types, *code };
             m_mir_res = &mir_res;
 
+            // Place the function in the least-full unit (deterministic, as emission order is fixed)
+            {
+                size_t unit = ::std::min_element(m_unit_sizes.begin(), m_unit_sizes.end()) - m_unit_sizes.begin();
+                m_unit_sizes[unit] += 1;
+                for(const auto& blk : code->blocks)
+                    m_unit_sizes[unit] += 1 + blk.statements.size();
+                select_unit(unit);
+            }
+
             m_of << "// " << p << "\n";
             if( is_extern_def ) {
-                m_of << "static ";
+                m_of << extern_def_linkage();
             }
             emit_function_header(p, item, params);
             m_of << "\n";
@@ -6258,7 +6465,7 @@ namespace {
     Span CodeGenerator_C::sp;
 }
 
-::std::unique_ptr<CodeGenerator> Trans_Codegen_GetGeneratorC(const ::HIR::Crate& crate, const ::std::string& outfile)
+::std::unique_ptr<CodeGenerator> Trans_Codegen_GetGeneratorC(const ::HIR::Crate& crate, const ::std::string& outfile, unsigned int codegen_units)
 {
-    return ::std::unique_ptr<CodeGenerator>(new CodeGenerator_C(crate, outfile));
+    return ::std::unique_ptr<CodeGenerator>(new CodeGenerator_C(crate, outfile, codegen_units));
 }
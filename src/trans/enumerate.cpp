@@ -16,6 +16,8 @@
 #include <hir_typeck/static.hpp>    // StaticTraitResolve
 #include <hir/item_path.hpp>
 #include <deque>
+#include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
 
 namespace {
@@ -359,24 +361,8 @@ TransList Trans_Enumerate_Public(::HIR::Crate& crate)
     };
 
     // Strip out any functions/types/statics that are still generic?
-    for(auto it = rv.m_functions.begin(); it != rv.m_functions.end(); )
-    {
-        if( H::is_generic(it->first) ) {
-            rv.m_functions.erase(it++);
-        }
-        else {
-            ++ it;
-        }
-    }
-    for(auto it = rv.m_statics.begin(); it != rv.m_statics.end(); )
-    {
-        if( H::is_generic(it->first) ) {
-            rv.m_statics.erase(it++);
-        }
-        else {
-            ++ it;
-        }
-    }
+    rv.m_functions.erase_if([](const auto& e){ return H::is_generic(e.first); });
+    rv.m_statics.erase_if([](const auto& e){ return H::is_generic(e.first); });
     return rv;
 }
 
@@ -404,26 +390,23 @@ void Trans_Enumerate_Cleanup(const ::HIR::Crate& crate, TransList& list)
     }
 
     // Remove any item in `list.m_functions` that doesn't appear in `state.rv.m_functions`
-    for(auto it = list.m_functions.begin(); it != list.m_functions.end();)
-    {
-        auto it2 = state.rv.m_functions.find(it->first);
-        if( it2 == state.rv.m_functions.end() )
+    list.m_functions.erase_if([&](const auto& e) {
+        if( !state.rv.m_functions.find(e.first) )
         {
-            DEBUG("Remove " << it->first);
-            it = list.m_functions.erase(it);
+            DEBUG("Remove " << e.first);
+            return true;
         }
         else
         {
-            DEBUG("Keep " << it->first);
-            ++ it;
+            DEBUG("Keep " << e.first);
+            return false;
         }
-    }
+        });
 
     // Sanity check: all items in `state.rv.m_functions` must exist in `list.m_functions`
     for(const auto& e : state.rv.m_functions)
     {
-        auto it = list.m_functions.find(e.first);
-        ASSERT_BUG(Span(), it != list.m_functions.end(), "Enumerate Error - New function appeared after monomorphisation - " << e.first);
+        ASSERT_BUG(Span(), list.m_functions.find(e.first), "Enumerate Error - New function appeared after monomorphisation - " << e.first);
     }
 }
 #endif
@@ -437,7 +420,7 @@ void Trans_Enumerate_CommonPost_Run(EnumState& state)
         auto& fcn_out = *state.fcn_queue.front();
         state.fcn_queue.pop_front();
 
-        TRACE_FUNCTION_F("Function " << ::std::find_if(state.rv.m_functions.begin(), state.rv.m_functions.end(), [&](const auto&x){ return x.second.get() == &fcn_out; })->first);
+        TRACE_FUNCTION_F("Function " << *fcn_out.path);
 
         Trans_Enumerate_FillFrom(state, *fcn_out.ptr, fcn_out.pp);
     }
@@ -452,21 +435,15 @@ TransList Trans_Enumerate_CommonPost(EnumState& state)
 
 namespace
 {
-    struct PtrComp
-    {
-        template<typename T>
-        bool operator()(const T* lhs, const T* rhs) const { return *lhs < *rhs; }
-    };
-
     struct TypeVisitor
     {
         const ::HIR::Crate& m_crate;
         ::StaticTraitResolve    m_resolve;
         ::std::vector< ::std::pair< ::HIR::TypeRef, bool> >& out_list;
 
-        // TODO: Have a list of indexes into `out_list`, sorted by typeref ordering
-        ::std::vector<size_t>   visited_map;
-        ::std::set< const ::HIR::TypeRef*, PtrComp> active_set;
+        // Index into `out_list` of the most complete visit of each type
+        ::std::unordered_map< ::HIR::TypeRef, size_t>  visited_map;
+        ::std::unordered_set< ::HIR::TypeRef>  active_set;
 
         TypeVisitor(const ::HIR::Crate& crate, ::std::vector< ::std::pair< ::HIR::TypeRef, bool > >& out_list):
             m_crate(crate),
@@ -556,10 +533,10 @@ namespace
         {
             // If the type has already been visited, AND either this is a shallow visit, or the previous wasn't
             {
-                auto idx_it = ::std::lower_bound(visited_map.begin(), visited_map.end(), ty, [&](size_t i, const ::HIR::TypeRef& t){ return out_list[i].first < t; });
-                if( idx_it != visited_map.end() && out_list[*idx_it].first == ty)
+                auto idx_it = visited_map.find(ty);
+                if( idx_it != visited_map.end() )
                 {
-                    auto it = &out_list[*idx_it];
+                    auto it = &out_list[idx_it->second];
                     if( it->second == false || mode == Mode::Shallow )
                     {
                         // Return early
@@ -590,11 +567,10 @@ namespace
             }
             else
             {
-                if( active_set.find(&ty) != active_set.end() ) {
+                if( !active_set.insert(ty.clone()).second ) {
                     // TODO: Handle recursion
                     BUG(Span(), "- Type recursion on " << ty);
                 }
-                active_set.insert( &ty );
 
                 TU_MATCHA( (ty.m_data), (te),
                 // Impossible
@@ -680,24 +656,19 @@ namespace
                         visit_type(sty, mode);
                     )
                 )
-                active_set.erase( active_set.find(&ty) );
+                active_set.erase(ty);
             }
 
             bool shallow = (mode == Mode::Shallow);
             {
-                auto idx_it = ::std::lower_bound(visited_map.begin(), visited_map.end(), ty, [&](size_t i, const ::HIR::TypeRef& t){ return out_list[i].first < t; });
-                if( idx_it == visited_map.end() || out_list[*idx_it].first != ty )
-                {
-                    // Add a new entry
-                    visited_map.insert(idx_it, out_list.size());
-                }
-                else
+                auto ins = visited_map.insert(::std::make_pair(ty.clone(), out_list.size()));
+                if( !ins.second )
                 {
                     // Previous visit was shallow, but this one isn't
                     // - Update the entry to the to-be-pushed entry with shallow=false
-                    if( !shallow && out_list[*idx_it].second )
+                    if( !shallow && out_list[ins.first->second].second )
                     {
-                        *idx_it = out_list.size();
+                        ins.first->second = out_list.size();
                     }
                 }
             }
@@ -19,6 +19,8 @@ struct TransOptions
     unsigned int opt_level = 0;
     bool emit_debug_info = false;
     ::std::string   build_command_file;
+    /// Number of C files (and parallel compiler invocations) the C backend splits its output into
+    unsigned int codegen_units = 1;
 
     ::std::vector< ::std::string>   library_search_dirs;
     ::std::vector< ::std::string>   libraries;
@@ -41,5 +43,7 @@ extern void Trans_Enumerate_Cleanup(const ::HIR::Crate& crate, TransList& list);
 extern void Trans_AutoImpls(::HIR::Crate& crate, TransList& trans_list);
 
 extern void Trans_Monomorphise_List(const ::HIR::Crate& crate, TransList& list);
+/// Enable the on-disk cache of monomorphised functions (`options` are the settings that affect the generated MIR)
+extern void Trans_Monomorphise_SetMirCache(const ::std::string& dir, const ::std::string& options);
 
 extern void Trans_Codegen(const ::std::string& outfile, CodegenOutput out_ty, const TransOptions& opt, const ::HIR::Crate& crate, const TransList& list, const ::std::string& hir_file);
@@ -11,6 +11,24 @@
 #include <hir/hir.hpp>
 #include <mir/operations.hpp>   // Needed for post-monomorph checks and optimisations
 #include <hir_conv/constant_evaluation.hpp>
+#include <thread_pool.hpp>
+#include <hir/main_bindings.hpp>   // HIR_(De)SerialiseMonomorphisedMir
+#include <hir_conv/main_bindings.hpp>  // ConvertHIR_Bind_Mir
+#include <hir_typeck/common.hpp>    // visit_path_tys_with
+#include <version.hpp>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <thread>
+#include <cstdio>   // std::rename
+#ifdef _WIN32
+# include <direct.h>    // _mkdir
+# include <process.h>   // _getpid
+# define getpid _getpid
+#else
+# include <sys/stat.h>  // mkdir
+# include <unistd.h>    // getpid
+#endif
 
 namespace {
     ::MIR::LValue monomorph_LValue(const ::StaticTraitResolve& resolve, const Trans_Params& params, const ::MIR::LValue& tpl)
@@ -314,10 +332,239 @@ namespace {
     return ::MIR::FunctionPointer( box$(output).release() );
 }
 
+namespace {
+    ::std::string   g_mir_cache_dir;
+    ::std::string   g_mir_cache_salt;
+
+    // FNV-1a
+    uint64_t hash_bytes(uint64_t h, const void* data, size_t len)
+    {
+        const auto* p = static_cast<const uint8_t*>(data);
+        for(size_t i = 0; i < len; i ++)
+        {
+            h ^= p[i];
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+    const uint64_t HASH_INIT = 0xcbf29ce484222325ull;
+
+    /// On-disk cache of monomorphised (and optimised) functions, shared between crates built with the same compiler
+    ///
+    /// Entries are keyed on the function path, the compiler version/options, and the metadata of every crate that
+    /// the path refers to (including their dependencies). Functions that refer to the current crate are never cached.
+    class MirCache
+    {
+        const ::HIR::Crate& m_crate;
+        /// Hash of each loaded crate's metadata file, combined with the hashes of its dependencies
+        ::std::map<RcString, uint64_t>  m_crate_hashes;
+        /// Crates with inherent impls on non-path types (e.g. `impl<T> [T]`), used for such UFCS paths
+        ::std::set<RcString>    m_primitive_impl_crates;
+
+        mutable ::std::atomic<unsigned>  m_hits;
+        mutable ::std::atomic<unsigned>  m_misses;
+        /// Set when the cache directory can't be read or written, the rest of the compilation runs without the cache
+        mutable ::std::atomic<bool> m_failed;
+    public:
+        MirCache(const ::HIR::Crate& crate):
+            m_crate(crate),
+            m_hits(0),
+            m_misses(0),
+            m_failed(false)
+        {
+            if( !enabled() )
+                return ;
+            TRACE_FUNCTION;
+#ifdef _WIN32
+            _mkdir(g_mir_cache_dir.c_str());
+#else
+            mkdir(g_mir_cache_dir.c_str(), 0777);
+#endif
+            for(const auto& ec : crate.m_ext_crates)
+            {
+                get_crate_hash(ec.first);
+                const auto& ti = ec.second.m_data->m_type_impls;
+                if( !ti.non_named.empty() || !ti.generic.empty() )
+                    m_primitive_impl_crates.insert(ec.first);
+            }
+        }
+        ~MirCache()
+        {
+            if( enabled() )
+                DEBUG("MIR cache: " << m_hits << " hits, " << m_misses << " misses");
+        }
+
+        bool enabled() const { return g_mir_cache_dir != "" && !m_failed; }
+
+        /// Get the cache key for a function, returns an empty string if the function can't be cached
+        ::std::string get_key(const ::HIR::Path& path) const
+        {
+            ::std::set<RcString>    crates;
+            bool is_local = false;
+            auto add_crate = [&](const RcString& name) {
+                if( name == "" || name == m_crate.m_crate_name || m_crate_hashes.count(name) == 0 )
+                    is_local = true;
+                else
+                    crates.insert(name);
+                };
+            auto add_path = [&](const ::HIR::Path& p) {
+                TU_MATCH_HDRA( (p.m_data), {)
+                TU_ARMA(Generic, e) {
+                    add_crate(e.m_path.m_crate_name);
+                    }
+                TU_ARMA(UfcsKnown, e) {
+                    add_crate(e.trait.m_path.m_crate_name);
+                    }
+                TU_ARMA(UfcsInherent, e) {
+                    // The impl is in the same crate as the type (visited below), unless the type is a primitive
+                    if( !e.type->get_sort_path() )
+                        crates.insert(m_primitive_impl_crates.begin(), m_primitive_impl_crates.end());
+                    }
+                TU_ARMA(UfcsUnknown, e) {
+                    is_local = true;
+                    }
+                }
+                };
+            add_path(path);
+            visit_path_tys_with(path, [&](const ::HIR::TypeRef& ty)->bool {
+                if( const auto* te = ty.m_data.opt_Path() ) {
+                    add_path(te->path);
+                }
+                else if( const auto* te = ty.m_data.opt_TraitObject() ) {
+                    add_crate(te->m_trait.m_path.m_path.m_crate_name);
+                    for(const auto& m : te->m_markers)
+                        add_crate(m.m_path.m_crate_name);
+                }
+                else if( ty.m_data.is_Closure() || ty.m_data.is_ErasedType() ) {
+                    is_local = true;
+                }
+                return is_local;
+                });
+            if( is_local )
+                return "";
+
+            ::std::stringstream ss;
+            ss << g_mir_cache_salt << "\n" << path;
+            for(const auto& c : crates)
+                ss << "\n" << c << "=" << ::std::hex << m_crate_hashes.at(c) << ::std::dec;
+            return ss.str();
+        }
+
+        bool load(const ::std::string& key, CachedFunction& out) const
+        {
+            ::HIR::TypeRef  ret_ty;
+            ::std::vector< ::HIR::TypeRef>  arg_tys;
+            ::MIR::FunctionPointer  mir;
+            try
+            {
+                if( !HIR_DeserialiseMonomorphisedMir(get_filename(key), key, ret_ty, arg_tys, mir) )
+                {
+                    m_misses ++;
+                    return false;
+                }
+            }
+            catch(const ::std::exception& e)
+            {
+                disable(FMT("Unable to read " << get_filename(key) << ": " << e.what()));
+                return false;
+            }
+            m_hits ++;
+            // The cache only stores paths and types, they need to be bound to this compilation's items
+            ConvertHIR_Bind_Mir(m_crate, ret_ty, arg_tys, *mir);
+            out.ret_ty = mv$(ret_ty);
+            out.arg_tys.clear();
+            for(auto& ty : arg_tys)
+                out.arg_tys.push_back(::std::make_pair( ::HIR::Pattern{}, mv$(ty) ));
+            out.code = mv$(mir);
+            return true;
+        }
+        void save(const ::std::string& key, const CachedFunction& fcn) const
+        {
+            ::std::vector< ::HIR::TypeRef>  arg_tys;
+            for(const auto& a : fcn.arg_tys)
+                arg_tys.push_back(a.second.clone());
+            // Write to a temporary file then rename, so concurrent compilations never see a partial entry
+            // - The name is unique to this process and thread, as other compilations may be saving the same entry
+            auto filename = get_filename(key);
+            auto tmp_filename = FMT(filename << ".tmp" << getpid() << "_" << ::std::hash<::std::thread::id>()(::std::this_thread::get_id()));
+            try
+            {
+                HIR_SerialiseMonomorphisedMir(tmp_filename, key, fcn.ret_ty, arg_tys, *fcn.code);
+            }
+            catch(const ::std::exception& e)
+            {
+                ::std::remove(tmp_filename.c_str());
+                disable(FMT("Unable to write " << tmp_filename << ": " << e.what()));
+                return ;
+            }
+            if( ::std::rename(tmp_filename.c_str(), filename.c_str()) != 0 )
+            {
+                ::std::remove(tmp_filename.c_str());
+            }
+        }
+
+    private:
+        /// Stop using the cache for the rest of this compilation (only the first failure is reported)
+        void disable(const ::std::string& reason) const
+        {
+            if( !m_failed.exchange(true) )
+            {
+                WARNING(Span(), W0000, "MIR cache disabled - " << reason);
+            }
+        }
+        ::std::string get_filename(const ::std::string& key) const
+        {
+            auto h = hash_bytes(HASH_INIT, key.data(), key.size());
+            return FMT(g_mir_cache_dir << "/" << ::std::hex << ::std::setw(16) << ::std::setfill('0') << h << ".mir");
+        }
+        uint64_t get_crate_hash(const RcString& name)
+        {
+            auto it = m_crate_hashes.find(name);
+            if( it != m_crate_hashes.end() )
+                return it->second;
+            const auto& ec = m_crate.m_ext_crates.at(name);
+
+            uint64_t h = HASH_INIT;
+            {
+                ::std::ifstream is(ec.m_path + ".hir", ::std::ios_base::in|::std::ios_base::binary);
+                char buf[16*1024];
+                do {
+                    is.read(buf, sizeof buf);
+                    h = hash_bytes(h, buf, is.gcount());
+                } while( is );
+            }
+            // Dependencies are listed in a sorted map, so the combined hash is stable
+            ::std::map<RcString, uint64_t>  deps;
+            for(const auto& dep : ec.m_data->m_ext_crates)
+                deps.insert(::std::make_pair(dep.first, 0));
+            for(auto& dep : deps)
+            {
+                dep.second = get_crate_hash(dep.first);
+                h = hash_bytes(h, dep.first.c_str(), dep.first.size());
+                h = hash_bytes(h, &dep.second, sizeof(dep.second));
+            }
+            DEBUG(name << " = " << ::std::hex << h << ::std::dec);
+            m_crate_hashes.insert(::std::make_pair(name, h));
+            return h;
+        }
+    };
+}
+
+void Trans_Monomorphise_SetMirCache(const ::std::string& dir, const ::std::string& options)
+{
+    g_mir_cache_dir = dir;
+    g_mir_cache_salt = FMT(Version_GetString() << " " << gsVersion_BuildTime << " " << options);
+}
+
 /// Monomorphise all functions in a TransList
 void Trans_Monomorphise_List(const ::HIR::Crate& crate, TransList& list)
 {
     ::StaticTraitResolve    resolve { crate };
+    MirCache    cache { crate };
+
+    // Collect the functions that need monomorphising, then process them in parallel
+    // - Each entry only writes to its own `monomorphised` field, the shared `resolve` caches are locked internally.
+    ::std::vector< ::std::pair<const ::HIR::Path*, TransList_Function*> >  to_monomorph;
     for(auto& fcn_ent : list.m_functions)
     {
         const auto& fcn = *fcn_ent.second->ptr;
@@ -325,32 +572,55 @@ void Trans_Monomorphise_List(const ::HIR::Crate& crate, TransList& list)
         bool is_method = ( fcn.m_args.size() > 0 && visit_ty_with(fcn.m_args[0].second, [&](const auto& x){return x == ::HIR::TypeRef("Self",0xFFFF);}) );
         if(fcn_ent.second->pp.has_types() || is_method)
         {
-            const auto& path = fcn_ent.first;
-            const auto& pp = fcn_ent.second->pp;
-            TRACE_FUNCTION_FR(path, path);
-            ASSERT_BUG(Span(), fcn.m_code.m_mir, "No code for " << path);
-
-            auto mir = Trans_Monomorphise(resolve, fcn_ent.second->pp, fcn.m_code.m_mir);
-
-            // TODO: Should these be moved to their own pass? Potentially not, the extra pass should just be an inlining optimise pass
-            auto ret_type = pp.monomorph(resolve, fcn.m_return);
-            ::HIR::Function::args_t args;
-            for(const auto& a : fcn.m_args)
-                args.push_back(::std::make_pair( ::HIR::Pattern{}, pp.monomorph(resolve, a.second) ));
-
-            //::std::string s = FMT(path);
-            ::HIR::ItemPath ip(path);
-            MIR_Validate(resolve, ip, *mir, args, ret_type);
-            MIR_Cleanup(resolve, ip, *mir, args, ret_type);
-            MIR_Optimise(resolve, ip, *mir, args, ret_type);
-            MIR_Validate(resolve, ip, *mir, args, ret_type);
-
-            fcn_ent.second->monomorphised.ret_ty = ::std::move(ret_type);
-            fcn_ent.second->monomorphised.arg_tys = ::std::move(args);
-            fcn_ent.second->monomorphised.code = ::std::move(mir);
+            to_monomorph.push_back(::std::make_pair( &fcn_ent.first, &*fcn_ent.second ));
         }
     }
 
+    ThreadPool  pool;
+    pool.for_each_index(to_monomorph.size(), [&](size_t i) {
+        const auto& path = *to_monomorph[i].first;
+        auto& fcn_ent = *to_monomorph[i].second;
+        const auto& fcn = *fcn_ent.ptr;
+        const auto& pp = fcn_ent.pp;
+        TRACE_FUNCTION_FR(path, path);
+        ASSERT_BUG(Span(), fcn.m_code.m_mir, "No code for " << path);
+
+        ::std::string   cache_key;
+        if( cache.enabled() )
+        {
+            cache_key = cache.get_key(path);
+            if( cache_key != "" && cache.load(cache_key, fcn_ent.monomorphised) )
+            {
+                DEBUG("Loaded from cache");
+                return ;
+            }
+        }
+
+        auto mir = Trans_Monomorphise(resolve, pp, fcn.m_code.m_mir);
+
+        // TODO: Should these be moved to their own pass? Potentially not, the extra pass should just be an inlining optimise pass
+        auto ret_type = pp.monomorph(resolve, fcn.m_return);
+        ::HIR::Function::args_t args;
+        for(const auto& a : fcn.m_args)
+            args.push_back(::std::make_pair( ::HIR::Pattern{}, pp.monomorph(resolve, a.second) ));
+
+        //::std::string s = FMT(path);
+        ::HIR::ItemPath ip(path);
+        MIR_Validate(resolve, ip, *mir, args, ret_type);
+        MIR_Cleanup(resolve, ip, *mir, args, ret_type);
+        MIR_Optimise(resolve, ip, *mir, args, ret_type);
+        MIR_Validate(resolve, ip, *mir, args, ret_type);
+
+        fcn_ent.monomorphised.ret_ty = ::std::move(ret_type);
+        fcn_ent.monomorphised.arg_tys = ::std::move(args);
+        fcn_ent.monomorphised.code = ::std::move(mir);
+
+        if( cache_key != "" )
+        {
+            cache.save(cache_key, fcn_ent.monomorphised);
+        }
+        });
+
     // Also do constants and statics (stored in where?)
     // - NOTE: Done in reverse order, because consteval needs used constants to be evaluated
     for(auto& ent : reverse(list.m_constants))
@@ -10,6 +10,10 @@
 #include "../expand/cfg.hpp"
 #include <fstream>
 #include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <unordered_map>
 #include <hir/hir.hpp>
 #include <hir_typeck/helpers.hpp>
 #include <toml.h>   // tools/common
@@ -46,6 +50,31 @@ const TargetArch ARCH_M68K = {
 };
 TargetSpec  g_target;
 
+namespace {
+    /// Memoised layouts (size/alignment, field offsets and niche/variant encoding)
+    ///
+    /// Layouts of fully-known types only depend on the target, so the cache is shared by all resolvers and threads.
+    /// Layouts of types containing generics depend on the caller's bounds, so sizes of those aren't cached, and their
+    /// reprs are stored per set of generics.
+    /// Only successful results are stored, failures (e.g. from unbound generics) depend on the caller's context.
+    struct LayoutCache
+    {
+        // NOTE: The lock isn't held while generating, as that recurses into the cache for inner types.
+        // - If two threads generate the same entry, the first one inserted wins (the results are identical)
+        ::std::shared_timed_mutex   lock;
+        ::std::unordered_map< ::HIR::TypeRef, ::std::unique_ptr<TypeRepr> > reprs;
+        ::std::unordered_map< ::HIR::TypeRef, ::std::pair<size_t,size_t> >  size_align;
+        // Reprs of types containing generics, keyed by the resolver's impl and item generics
+        ::std::map< ::std::pair< ::std::pair<const ::HIR::GenericParams*, const ::HIR::GenericParams*>, ::HIR::TypeRef>, ::std::unique_ptr<TypeRepr> >  generic_reprs;
+
+        ::std::atomic<size_t>   repr_hits { 0 };
+        ::std::atomic<size_t>   repr_misses { 0 };
+        ::std::atomic<size_t>   size_hits { 0 };
+        ::std::atomic<size_t>   size_misses { 0 };
+    };
+    LayoutCache g_layout_cache;
+}
+
 
 bool Target_GetSizeAndAlignOf(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_size, size_t& out_align);
 
@@ -610,191 +639,231 @@ void Target_SetCfg(const ::std::string& target_name)
         });
 }
 
-bool Target_GetSizeAndAlignOf(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_size, size_t& out_align)
-{
-    TRACE_FUNCTION_FR(ty, "size=" << out_size << ", align=" << out_align);
-    TU_MATCHA( (ty.m_data), (te),
-    (Infer,
-        BUG(sp, "sizeof on _ type");
-        ),
-    (Diverge,
-        out_size = 0;
-        out_align = 0;
-        return true;
-        ),
-    (Primitive,
-        switch(te)
-        {
-        case ::HIR::CoreType::Bool:
-        case ::HIR::CoreType::U8:
-        case ::HIR::CoreType::I8:
-            out_size = 1;
-            out_align = 1;  // u8 is always 1 aligned
-            return true;
-        case ::HIR::CoreType::U16:
-        case ::HIR::CoreType::I16:
-            out_size = 2;
-            out_align = g_target.m_arch.m_alignments.u16;
+namespace {
+    bool get_size_and_align_uncached(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_size, size_t& out_align)
+    {
+        TU_MATCHA( (ty.m_data), (te),
+        (Infer,
+            BUG(sp, "sizeof on _ type");
+            ),
+        (Diverge,
+            out_size = 0;
+            out_align = 0;
             return true;
-        case ::HIR::CoreType::U32:
-        case ::HIR::CoreType::I32:
-        case ::HIR::CoreType::Char:
-            out_size = 4;
-            out_align = g_target.m_arch.m_alignments.u32;
+            ),
+        (Primitive,
+            switch(te)
+            {
+            case ::HIR::CoreType::Bool:
+            case ::HIR::CoreType::U8:
+            case ::HIR::CoreType::I8:
+                out_size = 1;
+                out_align = 1;  // u8 is always 1 aligned
+                return true;
+            case ::HIR::CoreType::U16:
+            case ::HIR::CoreType::I16:
+                out_size = 2;
+                out_align = g_target.m_arch.m_alignments.u16;
+                return true;
+            case ::HIR::CoreType::U32:
+            case ::HIR::CoreType::I32:
+            case ::HIR::CoreType::Char:
+                out_size = 4;
+                out_align = g_target.m_arch.m_alignments.u32;
+                return true;
+            case ::HIR::CoreType::U64:
+            case ::HIR::CoreType::I64:
+                out_size = 8;
+                out_align = g_target.m_arch.m_alignments.u64;
+                return true;
+            case ::HIR::CoreType::U128:
+            case ::HIR::CoreType::I128:
+                out_size = 16;
+                // TODO: If i128 is emulated, this can be 8 (as it is on x86, where it's actually 4 due to the above comment)
+                if( g_target.m_backend_c.m_emulated_i128 )
+                    out_align = g_target.m_arch.m_alignments.u64;
+                else
+                    out_align = g_target.m_arch.m_alignments.u128;
+                return true;
+            case ::HIR::CoreType::Usize:
+            case ::HIR::CoreType::Isize:
+                out_size = g_target.m_arch.m_pointer_bits / 8;
+                out_align = g_target.m_arch.m_alignments.ptr;
+                return true;
+            case ::HIR::CoreType::F32:
+                out_size = 4;
+                out_align = g_target.m_arch.m_alignments.f32;
+                return true;
+            case ::HIR::CoreType::F64:
+                out_size = 8;
+                out_align = g_target.m_arch.m_alignments.f64;
+                return true;
+            case ::HIR::CoreType::Str:
+                DEBUG("sizeof on a `str` - unsized");
+                out_size  = SIZE_MAX;
+                out_align = 1;
+                return true;
+            }
+            ),
+        (Path,
+            if( te.binding.is_Opaque() )
+                return false;
+            if( te.binding.is_ExternType() )
+            {
+                DEBUG("sizeof on extern type - unsized");
+                out_align = 0;
+                out_size = SIZE_MAX;
+                return true;
+            }
+            const auto* repr = Target_GetTypeRepr(sp, resolve, ty);
+            if( !repr )
+            {
+                DEBUG("Cannot get type repr for " << ty);
+                return false;
+            }
+            out_size  = repr->size;
+            out_align = repr->align;
             return true;
-        case ::HIR::CoreType::U64:
-        case ::HIR::CoreType::I64:
-            out_size = 8;
-            out_align = g_target.m_arch.m_alignments.u64;
+            ),
+        (Generic,
+            // Unknown - return false
+            DEBUG("No repr for Generic - " << ty);
+            return false;
+            ),
+        (TraitObject,
+            out_align = 0;
+            out_size = SIZE_MAX;
+            DEBUG("sizeof on a trait object - unsized");
             return true;
-        case ::HIR::CoreType::U128:
-        case ::HIR::CoreType::I128:
-            out_size = 16;
-            // TODO: If i128 is emulated, this can be 8 (as it is on x86, where it's actually 4 due to the above comment)
-            if( g_target.m_backend_c.m_emulated_i128 )
-                out_align = g_target.m_arch.m_alignments.u64;
+            ),
+        (ErasedType,
+            BUG(sp, "sizeof on an erased type - shouldn't exist");
+            ),
+        (Array,
+            if( !Target_GetSizeAndAlignOf(sp, resolve, *te.inner, out_size,out_align) )
+                return false;
+            if( out_size == SIZE_MAX )
+                BUG(sp, "Unsized type in array - " << ty);
+            if( te.size_val == 0 || out_size == 0 )
+            {
+                out_size = 0;
+            }
             else
-                out_align = g_target.m_arch.m_alignments.u128;
+            {
+                if( SIZE_MAX / te.size_val <= out_size )
+                    BUG(sp, "Integer overflow calculating array size");
+                out_size *= te.size_val;
+            }
             return true;
-        case ::HIR::CoreType::Usize:
-        case ::HIR::CoreType::Isize:
-            out_size = g_target.m_arch.m_pointer_bits / 8;
-            out_align = g_target.m_arch.m_alignments.ptr;
+            ),
+        (Slice,
+            if( !Target_GetAlignOf(sp, resolve, *te.inner, out_align) )
+                return false;
+            out_size = SIZE_MAX;
+            DEBUG("sizeof on a slice - unsized");
             return true;
-        case ::HIR::CoreType::F32:
-            out_size = 4;
-            out_align = g_target.m_arch.m_alignments.f32;
+            ),
+        (Tuple,
+            const auto* repr = Target_GetTypeRepr(sp, resolve, ty);
+            if( !repr )
+            {
+                DEBUG("Cannot get type repr for " << ty);
+                return false;
+            }
+            out_size  = repr->size;
+            out_align = repr->align;
             return true;
-        case ::HIR::CoreType::F64:
-            out_size = 8;
-            out_align = g_target.m_arch.m_alignments.f64;
+            ),
+        (Borrow,
+            // - Alignment is machine native
+            out_align = g_target.m_arch.m_pointer_bits / 8;
+            // - Size depends on Sized-nes of the parameter
+            // TODO: Handle different types of Unsized (ones with different pointer sizes)
+            switch(resolve.metadata_type(sp, *te.inner))
+            {
+            case MetadataType::Unknown:
+                return false;
+            case MetadataType::None:
+            case MetadataType::Zero:
+                out_size = g_target.m_arch.m_pointer_bits / 8;
+                break;
+            case MetadataType::Slice:
+            case MetadataType::TraitObject:
+                out_size = g_target.m_arch.m_pointer_bits / 8 * 2;
+                break;
+            }
             return true;
-        case ::HIR::CoreType::Str:
-            DEBUG("sizeof on a `str` - unsized");
-            out_size  = SIZE_MAX;
-            out_align = 1;
+            ),
+        (Pointer,
+            // - Alignment is machine native
+            out_align = g_target.m_arch.m_pointer_bits / 8;
+            // - Size depends on Sized-nes of the parameter
+            switch(resolve.metadata_type(sp, *te.inner))
+            {
+            case MetadataType::Unknown:
+                return false;
+            case MetadataType::None:
+            case MetadataType::Zero:
+                out_size = g_target.m_arch.m_pointer_bits / 8;
+                break;
+            case MetadataType::Slice:
+            case MetadataType::TraitObject:
+                out_size = g_target.m_arch.m_pointer_bits / 8 * 2;
+                break;
+            }
             return true;
-        }
-        ),
-    (Path,
-        if( te.binding.is_Opaque() )
-            return false;
-        if( te.binding.is_ExternType() )
-        {
-            DEBUG("sizeof on extern type - unsized");
-            out_align = 0;
-            out_size = SIZE_MAX;
+            ),
+        (Function,
+            // Pointer size
+            out_size = g_target.m_arch.m_pointer_bits / 8;
+            out_align = g_target.m_arch.m_pointer_bits / 8;
             return true;
-        }
-        const auto* repr = Target_GetTypeRepr(sp, resolve, ty);
-        if( !repr )
-        {
-            DEBUG("Cannot get type repr for " << ty);
-            return false;
-        }
-        out_size  = repr->size;
-        out_align = repr->align;
-        return true;
-        ),
-    (Generic,
-        // Unknown - return false
-        DEBUG("No repr for Generic - " << ty);
+            ),
+        (Closure,
+            BUG(sp, "Encountered closure type at trans stage - " << ty);
+            )
+        )
         return false;
-        ),
-    (TraitObject,
-        out_align = 0;
-        out_size = SIZE_MAX;
-        DEBUG("sizeof on a trait object - unsized");
-        return true;
-        ),
-    (ErasedType,
-        BUG(sp, "sizeof on an erased type - shouldn't exist");
-        ),
-    (Array,
-        if( !Target_GetSizeAndAlignOf(sp, resolve, *te.inner, out_size,out_align) )
-            return false;
-        if( out_size == SIZE_MAX )
-            BUG(sp, "Unsized type in array - " << ty);
-        if( te.size_val == 0 || out_size == 0 )
-        {
-            out_size = 0;
-        }
-        else
-        {
-            if( SIZE_MAX / te.size_val <= out_size )
-                BUG(sp, "Integer overflow calculating array size");
-            out_size *= te.size_val;
-        }
-        return true;
-        ),
-    (Slice,
-        if( !Target_GetAlignOf(sp, resolve, *te.inner, out_align) )
-            return false;
-        out_size = SIZE_MAX;
-        DEBUG("sizeof on a slice - unsized");
-        return true;
-        ),
-    (Tuple,
-        const auto* repr = Target_GetTypeRepr(sp, resolve, ty);
-        if( !repr )
-        {
-            DEBUG("Cannot get type repr for " << ty);
-            return false;
-        }
-        out_size  = repr->size;
-        out_align = repr->align;
-        return true;
-        ),
-    (Borrow,
-        // - Alignment is machine native
-        out_align = g_target.m_arch.m_pointer_bits / 8;
-        // - Size depends on Sized-nes of the parameter
-        // TODO: Handle different types of Unsized (ones with different pointer sizes)
-        switch(resolve.metadata_type(sp, *te.inner))
-        {
-        case MetadataType::Unknown:
-            return false;
-        case MetadataType::None:
-        case MetadataType::Zero:
-            out_size = g_target.m_arch.m_pointer_bits / 8;
-            break;
-        case MetadataType::Slice:
-        case MetadataType::TraitObject:
-            out_size = g_target.m_arch.m_pointer_bits / 8 * 2;
-            break;
-        }
-        return true;
-        ),
-    (Pointer,
-        // - Alignment is machine native
-        out_align = g_target.m_arch.m_pointer_bits / 8;
-        // - Size depends on Sized-nes of the parameter
-        switch(resolve.metadata_type(sp, *te.inner))
+    }
+}
+bool Target_GetSizeAndAlignOf(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_size, size_t& out_align)
+{
+    TRACE_FUNCTION_FR(ty, "size=" << out_size << ", align=" << out_align);
+    // Fast path: Types with a fixed layout (or where the layout comes from the repr cache) aren't cached here
+    switch(ty.m_data.tag())
+    {
+    case ::HIR::TypeRef::Data::TAG_Array:
+    case ::HIR::TypeRef::Data::TAG_Slice:
+    case ::HIR::TypeRef::Data::TAG_Borrow:
+    case ::HIR::TypeRef::Data::TAG_Pointer:
+        break;
+    default:
+        return get_size_and_align_uncached(sp, resolve, ty, out_size, out_align);
+    }
+    // Layouts of generic types depend on the resolver's bounds (e.g. `&T` is a fat pointer if `T: ?Sized`)
+    if( ty.contains_generics() )
+    {
+        return get_size_and_align_uncached(sp, resolve, ty, out_size, out_align);
+    }
+
+    auto& cache = g_layout_cache;
+    {
+        ::std::shared_lock< ::std::shared_timed_mutex>  lh { cache.lock };
+        auto it = cache.size_align.find(ty);
+        if( it != cache.size_align.end() )
         {
-        case MetadataType::Unknown:
-            return false;
-        case MetadataType::None:
-        case MetadataType::Zero:
-            out_size = g_target.m_arch.m_pointer_bits / 8;
-            break;
-        case MetadataType::Slice:
-        case MetadataType::TraitObject:
-            out_size = g_target.m_arch.m_pointer_bits / 8 * 2;
-            break;
+            cache.size_hits ++;
+            out_size = it->second.first;
+            out_align = it->second.second;
+            return true;
         }
-        return true;
-        ),
-    (Function,
-        // Pointer size
-        out_size = g_target.m_arch.m_pointer_bits / 8;
-        out_align = g_target.m_arch.m_pointer_bits / 8;
-        return true;
-        ),
-    (Closure,
-        BUG(sp, "Encountered closure type at trans stage - " << ty);
-        )
-    )
-    return false;
+    }
+    cache.size_misses ++;
+    if( !get_size_and_align_uncached(sp, resolve, ty, out_size, out_align) )
+        return false;
+    ::std::unique_lock< ::std::shared_timed_mutex>  lh { cache.lock };
+    cache.size_align.insert(::std::make_pair( ty.clone(), ::std::make_pair(out_size, out_align) ));
+    return true;
 }
 bool Target_GetSizeOf(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_size)
 {
@@ -1290,19 +1359,56 @@ namespace {
 }
 const TypeRepr* Target_GetTypeRepr(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty)
 {
-    // TODO: Thread safety
-    // Map of generic types to type representations.
-    static ::std::map<::HIR::TypeRef, ::std::unique_ptr<TypeRepr>>  s_cache;
+    auto& cache = g_layout_cache;
+    // Reprs are handed out by pointer so must be stored, generic types are keyed by the generics in scope (which
+    // provide their bounds)
+    if( ty.contains_generics() )
+    {
+        auto key = ::std::make_pair( ::std::make_pair(resolve.m_impl_generics, resolve.m_item_generics), ty.clone() );
+        {
+            ::std::shared_lock< ::std::shared_timed_mutex>  lh { cache.lock };
+            auto it = cache.generic_reprs.find(key);
+            if( it != cache.generic_reprs.end() )
+            {
+                cache.repr_hits ++;
+                return it->second.get();
+            }
+        }
+        cache.repr_misses ++;
 
-    auto it = s_cache.find(ty);
-    if( it != s_cache.end() )
+        auto repr = make_type_repr(sp, resolve, ty);
+        if( !repr )
+            return nullptr;
+        ::std::unique_lock< ::std::shared_timed_mutex>  lh { cache.lock };
+        auto ires = cache.generic_reprs.insert(::std::make_pair( mv$(key), mv$(repr) ));
+        return ires.first->second.get();
+    }
     {
-        return it->second.get();
+        ::std::shared_lock< ::std::shared_timed_mutex>  lh { cache.lock };
+        auto it = cache.reprs.find(ty);
+        if( it != cache.reprs.end() )
+        {
+            cache.repr_hits ++;
+            return it->second.get();
+        }
     }
+    cache.repr_misses ++;
 
-    auto ires = s_cache.insert(::std::make_pair( ty.clone(), make_type_repr(sp, resolve, ty) ));
+    auto repr = make_type_repr(sp, resolve, ty);
+    if( !repr )
+        return nullptr;
+    ::std::unique_lock< ::std::shared_timed_mutex>  lh { cache.lock };
+    auto ires = cache.reprs.insert(::std::make_pair( ty.clone(), mv$(repr) ));
     return ires.first->second.get();
 }
+void Target_GetLayoutCacheStats(::std::vector< ::std::pair<const char*, size_t> >& out)
+{
+    const auto& cache = g_layout_cache;
+    out.push_back(::std::make_pair("layout_repr_hits", cache.repr_hits.load()));
+    out.push_back(::std::make_pair("layout_repr_misses", cache.repr_misses.load()));
+    out.push_back(::std::make_pair("layout_size_hits", cache.size_hits.load()));
+    out.push_back(::std::make_pair("layout_size_misses", cache.size_misses.load()));
+}
 const ::HIR::TypeRef& Target_GetInnerType(const Span& sp, const StaticTraitResolve& resolve, const TypeRepr& repr, size_t idx, const ::std::vector<size_t>& sub_fields, size_t ofs)
 {
     const auto& ty = repr.fields.at(idx).ty;
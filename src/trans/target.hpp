@@ -127,6 +127,8 @@ extern bool Target_GetAlignOf(const Span& sp, const StaticTraitResolve& resolve,
 extern bool Target_GetSizeAndAlignOf(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty, size_t& out_size, size_t& out_align);
 
 extern const TypeRepr* Target_GetTypeRepr(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty);
+/// Layout cache hit/miss counters (for `--phase-stats`)
+extern void Target_GetLayoutCacheStats(::std::vector< ::std::pair<const char*, size_t> >& out);
 
 extern const ::HIR::TypeRef& Target_GetInnerType(const Span& sp, const StaticTraitResolve& resolve, const TypeRepr& repr, size_t idx, const ::std::vector<size_t>& sub_fields={}, size_t ofs=0);
 
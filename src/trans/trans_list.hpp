@@ -10,6 +10,9 @@
 #include <hir/type.hpp>
 #include <hir/path.hpp>
 #include <hir_typeck/common.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
 
 class StaticTraitResolve;
 namespace HIR {
@@ -49,7 +52,7 @@ struct CachedFunction {
 };
 struct TransList_Function
 {
-    const ::HIR::Path*  path;   // Pointer into the list (std::map pointers are stable)
+    const ::HIR::Path*  path;   // Pointer into the list (TransList_PathMap entries are stable)
     const ::HIR::Function*  ptr;
     Trans_Params    pp;
     // If `pp.has_types` is true, the below is valid
@@ -71,6 +74,101 @@ struct TransList_Const
     Trans_Params    pp;
 };
 
+/// Map keyed by path, with hashed lookup and iteration in path order
+///
+/// Enumeration does many more lookups/inserts than iterations, so the sorted order (needed for deterministic output)
+/// is only built when iterating after a modification. Entries never move once inserted.
+template<typename T>
+class TransList_PathMap
+{
+public:
+    typedef ::std::pair<const ::HIR::Path, T>   value_type;
+private:
+    ::std::unordered_map< ::HIR::Path, T>   m_map;
+    mutable ::std::vector<value_type*>  m_order;
+    mutable bool    m_order_valid = true;
+
+    const ::std::vector<value_type*>& order() const {
+        if( !m_order_valid )
+        {
+            m_order.clear();
+            m_order.reserve(m_map.size());
+            for(auto& e : const_cast<TransList_PathMap*>(this)->m_map)
+                m_order.push_back(&e);
+            ::std::sort(m_order.begin(), m_order.end(), [](const value_type* a, const value_type* b){ return a->first < b->first; });
+            m_order_valid = true;
+        }
+        return m_order;
+    }
+public:
+    template<typename V>
+    class iterator_t
+    {
+        typename ::std::vector<typename TransList_PathMap::value_type*>::const_iterator m_it;
+    public:
+        typedef ::std::bidirectional_iterator_tag   iterator_category;
+        typedef V   value_type;
+        typedef ptrdiff_t   difference_type;
+        typedef V*  pointer;
+        typedef V&  reference;
+
+        iterator_t(typename ::std::vector<typename TransList_PathMap::value_type*>::const_iterator it): m_it(it) {}
+        V& operator*() const { return **m_it; }
+        V* operator->() const { return *m_it; }
+        iterator_t& operator++() { ++m_it; return *this; }
+        iterator_t& operator--() { --m_it; return *this; }
+        bool operator==(const iterator_t& x) const { return m_it == x.m_it; }
+        bool operator!=(const iterator_t& x) const { return m_it != x.m_it; }
+    };
+    typedef iterator_t<value_type>  iterator;
+    typedef iterator_t<const value_type>    const_iterator;
+
+    TransList_PathMap() = default;
+    TransList_PathMap(TransList_PathMap&&) = default;
+    TransList_PathMap& operator=(TransList_PathMap&&) = default;
+
+    size_t size() const { return m_map.size(); }
+    bool empty() const { return m_map.empty(); }
+    size_t count(const ::HIR::Path& p) const { return m_map.count(p); }
+
+    /// Returns `nullptr` if the path isn't present
+    value_type* find(const ::HIR::Path& p) {
+        auto it = m_map.find(p);
+        return it == m_map.end() ? nullptr : &*it;
+    }
+    const value_type* find(const ::HIR::Path& p) const {
+        auto it = m_map.find(p);
+        return it == m_map.end() ? nullptr : &*it;
+    }
+    ::std::pair<value_type*, bool> insert(::std::pair< ::HIR::Path, T> v) {
+        auto rv = m_map.insert(::std::move(v));
+        if( rv.second )
+            m_order_valid = false;
+        return ::std::make_pair(&*rv.first, rv.second);
+    }
+    /// Remove all entries for which `cb` returns true
+    template<typename Cb>
+    void erase_if(Cb cb) {
+        for(auto it = m_map.begin(); it != m_map.end(); )
+        {
+            if( cb(*it) ) {
+                it = m_map.erase(it);
+                m_order_valid = false;
+            }
+            else {
+                ++ it;
+            }
+        }
+    }
+
+    iterator begin() { return iterator(order().begin()); }
+    iterator end() { return iterator(order().end()); }
+    const_iterator begin() const { return const_iterator(order().begin()); }
+    const_iterator end() const { return const_iterator(order().end()); }
+    ::std::reverse_iterator<iterator> rbegin() { return ::std::reverse_iterator<iterator>(end()); }
+    ::std::reverse_iterator<iterator> rend() { return ::std::reverse_iterator<iterator>(begin()); }
+};
+
 class TransList
 {
 public:
@@ -80,13 +178,13 @@ public:
     TransList& operator=(TransList&&) = default;
     TransList& operator=(const TransList&) = delete;
 
-    ::std::map< ::HIR::Path, ::std::unique_ptr<TransList_Function> > m_functions;
-    ::std::map< ::HIR::Path, ::std::unique_ptr<TransList_Static> > m_statics;
+    TransList_PathMap< ::std::unique_ptr<TransList_Function> > m_functions;
+    TransList_PathMap< ::std::unique_ptr<TransList_Static> > m_statics;
     /// Constants that are still Defer
-    ::std::map< ::HIR::Path, ::std::unique_ptr<TransList_Const> > m_constants;
-    ::std::map< ::HIR::Path, Trans_Params> m_vtables;
-    /// Required type_id values
-    ::std::set< ::HIR::TypeRef> m_typeids;
+    TransList_PathMap< ::std::unique_ptr<TransList_Const> > m_constants;
+    TransList_PathMap<Trans_Params> m_vtables;
+    /// Required type_id values (unordered, sort before emitting)
+    ::std::unordered_set< ::HIR::TypeRef> m_typeids;
     /// Required struct/enum constructor impls
     ::std::set< ::HIR::GenericPath> m_constructors;
     // Automatic Clone impls
@@ -5,7 +5,7 @@
 #include <mir/mir.hpp>
 #include <mir/operations.hpp>   // MIR_Dump_Fcn
 
-int g_debug_indent_level = 0;
+thread_local int g_debug_indent_level = 0;
 
 struct Args
 {
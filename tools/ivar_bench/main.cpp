@@ -0,0 +1,139 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * tools/ivar_bench/main.cpp
+ * - Ivar table benchmark
+ *
+ * Drives `HMTypeInferrence` with the ivar pattern of a large macro-generated function body (by default 50k ivars): long
+ * chains of ivars equated one after another, with the chain types nested inside each other. Reports the time taken to
+ * build the chains, and to look every ivar up with `expand_ivars` and `types_equal`.
+ */
+#include <hir_typeck/helpers.hpp>
+#include <debug_inner.hpp>
+#include <target_version.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+
+// Normally defined in the compiler's `main.cpp`
+TargetVersion   gTargetVersion = TargetVersion::Rustc1_29;
+
+struct Args
+{
+    Args(int argc, const char* const argv[]);
+
+    unsigned    ivar_count = 50000;
+    unsigned    chain_length = 1000;
+    unsigned    repeat = 5;
+};
+
+namespace {
+    struct Times {
+        double  build;
+        double  expand;
+        double  equal;
+    };
+    double since(::std::chrono::steady_clock::time_point start) {
+        return ::std::chrono::duration<double>(::std::chrono::steady_clock::now() - start).count();
+    }
+
+    Times run_pass(const Args& args, size_t& n_equal)
+    {
+        Times   rv;
+        HMTypeInferrence    ivars;
+
+        // Build: each chain is a run of ivars equated to the one before (e.g. `let a = ...; let b = a; let c = b; ...`)
+        // - Equating a new ivar with the previous one leaves the earliest ivar at the bottom of the chain
+        auto start = ::std::chrono::steady_clock::now();
+        ::std::vector<unsigned int> chain_heads;
+        for(unsigned i = 0; i < args.ivar_count; i ++)
+        {
+            auto idx = ivars.new_ivar();
+            if( i % args.chain_length == 0 )
+                chain_heads.push_back(idx);
+            else
+                ivars.ivar_unify(idx, idx - 1);
+        }
+        // Resolve each chain to `&(u32, <next chain>)` (the last to `&(u32, u32)`)
+        for(size_t c = chain_heads.size(); c --; )
+        {
+            ::std::vector< ::HIR::TypeRef>  tys;
+            tys.push_back( ::HIR::TypeRef(::HIR::CoreType::U32) );
+            if( c + 1 < chain_heads.size() )
+                tys.push_back( ::HIR::TypeRef::new_infer(chain_heads[c+1]) );
+            else
+                tys.push_back( ::HIR::TypeRef(::HIR::CoreType::U32) );
+            ivars.set_ivar_to(chain_heads[c], ::HIR::TypeRef::new_borrow(::HIR::BorrowType::Shared, ::HIR::TypeRef(mv$(tys))));
+        }
+        rv.build = since(start);
+
+        // Expand: replace each ivar with the type of its chain
+        start = ::std::chrono::steady_clock::now();
+        for(unsigned i = 0; i < args.ivar_count; i ++)
+        {
+            auto ty = ::HIR::TypeRef::new_infer(i);
+            ivars.expand_ivars(ty);
+            assert( ty.m_data.is_Borrow() );
+        }
+        rv.expand = since(start);
+
+        // Equal: compare every ivar against the start of its chain
+        start = ::std::chrono::steady_clock::now();
+        n_equal = 0;
+        for(unsigned i = 0; i < args.ivar_count; i ++)
+        {
+            auto head = chain_heads[i / args.chain_length];
+            if( ivars.types_equal(::HIR::TypeRef::new_infer(i), ::HIR::TypeRef::new_infer(head)) )
+                n_equal ++;
+        }
+        rv.equal = since(start);
+
+        return rv;
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    Args    args(argc, argv);
+    // Disable debug output (the compiler only enables it for the phases listed in $MRUSTC_DEBUG)
+    DebugThreadContext  dbg_ctxt({ 0, false }, nullptr);
+
+    Times   best {};
+    size_t  n_equal = 0;
+    for(unsigned pass = 0; pass < args.repeat; pass ++)
+    {
+        auto t = run_pass(args, n_equal);
+        if( pass == 0 || t.build + t.expand + t.equal < best.build + best.expand + best.equal )
+            best = t;
+    }
+
+    ::std::cout << args.ivar_count << " ivars, chains of " << args.chain_length << ", " << n_equal << " equal" << ::std::endl;
+    ::std::cout << "Best of " << args.repeat << ": "
+        << "build " << best.build * 1000 << " ms, "
+        << "expand " << best.expand * 1000 << " ms, "
+        << "equal " << best.equal * 1000 << " ms, "
+        << "total " << (best.build + best.expand + best.equal) * 1000 << " ms" << ::std::endl;
+    return 0;
+}
+
+Args::Args(int argc, const char* const argv[])
+{
+    for(int i = 1; i < argc; i ++)
+    {
+        const char* arg = argv[i];
+        if( strcmp(arg, "--repeat") == 0 && i+1 < argc ) {
+            this->repeat = ::std::max(1, atoi(argv[++i]));
+        }
+        else if( strcmp(arg, "--chain") == 0 && i+1 < argc ) {
+            this->chain_length = ::std::max(1, atoi(argv[++i]));
+        }
+        else if( arg[0] != '-' ) {
+            this->ivar_count = ::std::max(1, atoi(arg));
+        }
+        else {
+            ::std::cerr << "Usage: ivar_bench [--repeat <n>] [--chain <length>] [<ivar count>]" << ::std::endl;
+            exit(1);
+        }
+    }
+}
@@ -0,0 +1,136 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * tools/lex_bench/main.cpp
+ * - Lexer throughput benchmark
+ *
+ * Tokenises every `.rs` file under a directory (by default the bundled rustc's libcore) and reports MB/s.
+ */
+#include <parse/lex.hpp>
+#include <parse/parseerror.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#if _WIN32
+# include <Windows.h>
+#else
+# include <dirent.h>
+# include <sys/stat.h>
+#endif
+
+struct Args
+{
+    Args(int argc, const char* const argv[]);
+
+    ::std::string   root_dir = "rustc-1.29.0-src/src/libcore";
+    unsigned    repeat = 5;
+};
+
+namespace {
+    void find_sources(const ::std::string& dir, ::std::vector< ::std::string>& out)
+    {
+#if _WIN32
+        WIN32_FIND_DATA find_data;
+        HANDLE find_handle = FindFirstFile( (dir + "\\*").c_str(), &find_data );
+        if( find_handle == INVALID_HANDLE_VALUE )
+            return ;
+        do
+        {
+            ::std::string   name = find_data.cFileName;
+            bool is_dir = (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+#else
+        auto* dp = opendir(dir.c_str());
+        if( dp == nullptr )
+            return ;
+        while( const auto* dent = readdir(dp) )
+        {
+            ::std::string   name = dent->d_name;
+            struct stat s;
+            if( stat((dir + "/" + name).c_str(), &s) != 0 )
+                continue ;
+            bool is_dir = S_ISDIR(s.st_mode);
+#endif
+            if( name == "." || name == ".." )
+                continue ;
+            auto path = dir + "/" + name;
+            if( is_dir )
+                find_sources(path, out);
+            else if( name.size() > 3 && name.compare(name.size() - 3, 3, ".rs") == 0 )
+                out.push_back(path);
+        }
+#if _WIN32
+        while( FindNextFile(find_handle, &find_data) );
+        FindClose(find_handle);
+#else
+        closedir(dp);
+#endif
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    Args    args(argc, argv);
+
+    ::std::vector< ::std::string>   files;
+    find_sources(args.root_dir, files);
+    if( files.empty() )
+    {
+        ::std::cerr << "No .rs files found in '" << args.root_dir << "'" << ::std::endl;
+        return 1;
+    }
+
+    double  best_s = 0;
+    size_t  total_bytes = 0;
+    size_t  total_tokens = 0;
+    for(unsigned pass = 0; pass < args.repeat; pass ++)
+    {
+        size_t  bytes = 0;
+        size_t  tokens = 0;
+        auto start = ::std::chrono::steady_clock::now();
+        for(const auto& f : files)
+        {
+            try
+            {
+                Lexer   lex(f);
+                while( lex.getToken().type() != TOK_EOF )
+                    tokens ++;
+            }
+            catch(const ::std::exception& e)
+            {
+                ::std::cerr << f << ": " << e.what() << ::std::endl;
+            }
+            ::std::ifstream is(f, ::std::ios::binary | ::std::ios::ate);
+            bytes += static_cast<size_t>(is.tellg());
+        }
+        double s = ::std::chrono::duration<double>(::std::chrono::steady_clock::now() - start).count();
+        if( pass == 0 || s < best_s )
+            best_s = s;
+        total_bytes = bytes;
+        total_tokens = tokens;
+    }
+
+    ::std::cout << files.size() << " files, " << total_bytes << " bytes, " << total_tokens << " tokens" << ::std::endl;
+    ::std::cout << "Best of " << args.repeat << ": " << best_s << " s, "
+        << (total_bytes / best_s / (1024*1024)) << " MB/s, "
+        << (total_tokens / best_s / 1e6) << " Mtok/s" << ::std::endl;
+    return 0;
+}
+
+Args::Args(int argc, const char* const argv[])
+{
+    for(int i = 1; i < argc; i ++)
+    {
+        const char* arg = argv[i];
+        if( strcmp(arg, "--repeat") == 0 && i+1 < argc ) {
+            this->repeat = ::std::max(1, atoi(argv[++i]));
+        }
+        else if( arg[0] != '-' ) {
+            this->root_dir = arg;
+        }
+        else {
+            ::std::cerr << "Usage: lex_bench [--repeat <n>] [<source dir>]" << ::std::endl;
+            exit(1);
+        }
+    }
+}
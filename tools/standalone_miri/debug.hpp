@@ -58,14 +58,17 @@ class FunctionTrace
     const char* m_file;
     unsigned m_line;
     U   m_exit;
+    // Cached so the (hot) disabled path only does the lookup once
+    bool    m_enabled;
 public:
-    FunctionTrace(const char* fname, const char* file, unsigned line, T entry, U exit):
+    FunctionTrace(const char* fname, const char* file, unsigned line, const T& entry, U exit):
         m_fname(fname),
         m_file(file),
         m_line(line),
-        m_exit(exit)
+        m_exit(::std::move(exit)),
+        m_enabled(DebugSink::enabled(fname))
     {
-        if( DebugSink::enabled(fname) ) {
+        if( m_enabled ) {
             auto s = DebugSink::get(fname, file, line, DebugLevel::Debug);
             s << "(";
             (entry)(s);
@@ -73,8 +76,18 @@ public:
             DebugSink::inc_indent();
         }
     }
+    FunctionTrace(FunctionTrace&& x):
+        m_fname(x.m_fname),
+        m_file(x.m_file),
+        m_line(x.m_line),
+        m_exit(::std::move(x.m_exit)),
+        m_enabled(x.m_enabled)
+    {
+        x.m_enabled = false;
+    }
+    FunctionTrace(const FunctionTrace&) = delete;
     ~FunctionTrace() {
-        if( DebugSink::enabled(m_fname) ) {
+        if( m_enabled ) {
             DebugSink::dec_indent();
             auto s = DebugSink::get(m_fname, m_file, m_line, DebugLevel::Debug);
             s << "(";
@@ -84,8 +97,8 @@ public:
     }
 };
 template<typename T, typename U>
-FunctionTrace<T,U> FunctionTrace_d(const char* fname, const char* file, unsigned line, T entry, U exit) {
-    return FunctionTrace<T,U>(fname, file, line, entry, exit);
+FunctionTrace<T,U> FunctionTrace_d(const char* fname, const char* file, unsigned line, const T& entry, U exit) {
+    return FunctionTrace<T,U>(fname, file, line, entry, ::std::move(exit));
 }
 
 struct DebugExceptionTodo:
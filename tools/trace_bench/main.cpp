@@ -0,0 +1,108 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * tools/trace_bench/main.cpp
+ * - Function trace overhead benchmark
+ *
+ * Times a small recursive function instrumented with each of the TRACE_FUNCTION* macros while debug output is disabled
+ * (the normal state for every phase not listed in $MRUSTC_DEBUG), and reports the cost per call.
+ */
+#include <debug.hpp>
+#include <debug_inner.hpp>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+struct Args
+{
+    Args(int argc, const char* const argv[]);
+
+    unsigned    calls = 10000000;
+    unsigned    repeat = 5;
+};
+
+#ifdef _MSC_VER
+# define NOINLINE   __declspec(noinline)
+#else
+# define NOINLINE   __attribute__((noinline))
+#endif
+
+namespace {
+    // NOTE: `noinline` so the calls (and the trace objects) aren't folded away
+    NOINLINE unsigned plain(unsigned depth, const ::std::string& name) {
+        return depth == 0 ? name.size() : plain(depth - 1, name) + 1;
+    }
+    NOINLINE unsigned trace(unsigned depth, const ::std::string& name) {
+        TRACE_FUNCTION;
+        return depth == 0 ? name.size() : trace(depth - 1, name) + 1;
+    }
+    NOINLINE unsigned trace_f(unsigned depth, const ::std::string& name) {
+        TRACE_FUNCTION_F("depth=" << depth << ", name=" << name);
+        return depth == 0 ? name.size() : trace_f(depth - 1, name) + 1;
+    }
+    NOINLINE unsigned trace_fr(unsigned depth, const ::std::string& name) {
+        unsigned rv = 0;
+        TRACE_FUNCTION_FR("depth=" << depth << ", name=" << name, rv);
+        rv = depth == 0 ? name.size() : trace_fr(depth - 1, name) + 1;
+        return rv;
+    }
+
+    // Best time (over `repeat` runs) per call of `fcn`, in nanoseconds
+    double time_ns(const Args& args, unsigned (*fcn)(unsigned, const ::std::string&), unsigned& sink)
+    {
+        // Recurse a little (like typical traced helpers), so the indent level changes
+        const unsigned DEPTH = 8;
+        ::std::string   name = "function_name";
+        double  best = 0;
+        for(unsigned pass = 0; pass < args.repeat; pass ++)
+        {
+            auto start = ::std::chrono::steady_clock::now();
+            for(unsigned i = 0; i < args.calls / (DEPTH+1); i ++)
+                sink += fcn(DEPTH, name);
+            double s = ::std::chrono::duration<double>(::std::chrono::steady_clock::now() - start).count();
+            if( pass == 0 || s < best )
+                best = s;
+        }
+        return best * 1e9 / args.calls;
+    }
+}
+
+int main(int argc, const char* argv[])
+{
+    Args    args(argc, argv);
+    // Disable debug output (as it is for every phase not listed in $MRUSTC_DEBUG)
+    DebugThreadContext  dbg_ctxt({ 0, false }, nullptr);
+
+    unsigned    sink = 0;
+    double  base = time_ns(args, plain, sink);
+    double  t = time_ns(args, trace, sink);
+    double  t_f = time_ns(args, trace_f, sink);
+    double  t_fr = time_ns(args, trace_fr, sink);
+
+    ::std::cout << args.calls << " calls, best of " << args.repeat << " (" << sink % 2 << ")" << ::std::endl;
+    ::std::cout << "untraced:          " << base << " ns/call" << ::std::endl;
+    ::std::cout << "TRACE_FUNCTION:    " << t << " ns/call (+" << (t - base) << ")" << ::std::endl;
+    ::std::cout << "TRACE_FUNCTION_F:  " << t_f << " ns/call (+" << (t_f - base) << ")" << ::std::endl;
+    ::std::cout << "TRACE_FUNCTION_FR: " << t_fr << " ns/call (+" << (t_fr - base) << ")" << ::std::endl;
+    return 0;
+}
+
+Args::Args(int argc, const char* const argv[])
+{
+    for(int i = 1; i < argc; i ++)
+    {
+        const char* arg = argv[i];
+        if( strcmp(arg, "--repeat") == 0 && i+1 < argc ) {
+            this->repeat = ::std::max(1, atoi(argv[++i]));
+        }
+        else if( arg[0] != '-' ) {
+            this->calls = ::std::max(1, atoi(arg));
+        }
+        else {
+            ::std::cerr << "Usage: trace_bench [--repeat <n>] [<call count>]" << ::std::endl;
+            exit(1);
+        }
+    }
+}